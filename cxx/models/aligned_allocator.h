@@ -0,0 +1,76 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include "sparse_net_global.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+namespace sparse_net_library{
+
+/**
+ * The size of a cache line in bytes on the targeted architectures
+ */
+constexpr uint32 cache_line_bytes = 64;
+
+/**
+ * The size of a regular memory page in bytes on the targeted architectures
+ */
+constexpr uint32 page_bytes = 4096;
+
+/**
+ * @brief      An allocator for standard containers, which places the data at the given alignment in bytes.
+ *             Buffers written by multiple threads are aligned to cache lines with it, so the parts
+ *             of them owned by different threads can be kept from sharing a cache line.
+ */
+template<typename T, uint32 alignment = cache_line_bytes>
+class Aligned_allocator{
+public:
+  typedef T value_type;
+
+  template<typename U>
+  struct rebind{
+    typedef Aligned_allocator<U, alignment> other;
+  };
+
+  Aligned_allocator() = default;
+
+  template<typename U>
+  Aligned_allocator(const Aligned_allocator<U, alignment>&){ }
+
+  T* allocate(std::size_t number_of_elements){
+    void* data = nullptr;
+    const std::size_t bytes = std::max(static_cast<std::size_t>(1u), number_of_elements * sizeof(T));
+#if defined(_WIN32)
+    data = _aligned_malloc(bytes, alignment);
+#else
+    if(0 != posix_memalign(&data, alignment, bytes)) data = nullptr;
+#endif
+    if(nullptr == data) throw std::bad_alloc();
+    return static_cast<T*>(data);
+  }
+
+  void deallocate(T* data, std::size_t){
+#if defined(_WIN32)
+    _aligned_free(data);
+#else
+    free(data);
+#endif
+  }
+};
+
+template<typename T, typename U, uint32 alignment>
+bool operator==(const Aligned_allocator<T, alignment>&, const Aligned_allocator<U, alignment>&){
+  return true;
+}
+
+template<typename T, typename U, uint32 alignment>
+bool operator!=(const Aligned_allocator<T, alignment>&, const Aligned_allocator<U, alignment>&){
+  return false;
+}
+
+} /* namespace sparse_net_library */
+
+#endif /* ALIGNED_ALLOCATOR_H */
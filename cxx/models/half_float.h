@@ -0,0 +1,173 @@
+#ifndef HALF_FLOAT_H
+#define HALF_FLOAT_H
+
+#include <cstring>
+
+#include "sparse_net_global.h"
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace sparse_net_library{
+
+/**
+ * @brief      Conversion between 64 bit weights and the 16 bit formats of @weight_storages. Numbers are
+ *             converted through 32 bit floats, rounded to the nearest even on narrowing. Single half precision
+ *             numbers are converted with the F16C instructions when the library is compiled with them enabled;
+ *             arrays of them are converted with F16C whenever the CPU running the library supports it.
+ */
+class Half_float{
+public:
+  static uint16 fp16_from_float(float value){
+#if defined(__F16C__)
+    return _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+#else
+    const uint32 bits = float_bits(value);
+    const uint32 sign = (bits >> 16) & 0x8000u;
+    const uint32 exponent = (bits >> 23) & 0xFFu;
+    uint32 mantissa = bits & 0x7FFFFFu;
+    if(0xFFu == exponent) /* infinity or NaN */
+      return sign | 0x7C00u | ((0u != mantissa)? 0x200u : 0u);
+    const sint32 half_exponent = static_cast<sint32>(exponent) - 127 + 15;
+    if(0x1F <= half_exponent) return sign | 0x7C00u; /* too large, rounded to infinity */
+    if(0 >= half_exponent){ /* subnormal in half precision */
+      if(-10 > half_exponent) return sign; /* less than half of the smallest subnormal */
+      mantissa |= 0x800000u;
+      const uint32 shift = 14 - half_exponent;
+      const uint32 half_mantissa = mantissa >> shift;
+      return sign | round_to_nearest_even(half_mantissa, mantissa & ((1u << shift) - 1u), 1u << (shift - 1u));
+    }
+    const uint32 half = sign | (static_cast<uint32>(half_exponent) << 10) | (mantissa >> 13);
+    return round_to_nearest_even(half, mantissa & 0x1FFFu, 0x1000u); /* a carry steps into the exponent */
+#endif
+  }
+
+  static float fp16_to_float(uint16 half){
+#if defined(__F16C__)
+    return _cvtsh_ss(half);
+#else
+    const uint32 sign = static_cast<uint32>(half & 0x8000u) << 16;
+    uint32 exponent = (half >> 10) & 0x1Fu;
+    uint32 mantissa = half & 0x3FFu;
+    if(0x1Fu == exponent) return bits_float(sign | 0x7F800000u | (mantissa << 13)); /* infinity or NaN */
+    if(0u == exponent){
+      if(0u == mantissa) return bits_float(sign);
+      exponent = 127 - 14; /* subnormal: normalized in 32 bit */
+      while(0u == (mantissa & 0x400u)){
+        mantissa <<= 1;
+        --exponent;
+      }
+      return bits_float(sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13));
+    }
+    return bits_float(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+#endif
+  }
+
+  static uint16 bf16_from_float(float value){
+    const uint32 bits = float_bits(value);
+    if(((bits & 0x7F800000u) == 0x7F800000u)&&(0u != (bits & 0x7FFFFFu)))
+      return (bits >> 16) | 0x40u; /* NaN stays NaN even if its mantissa is cut off */
+    return (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+  }
+
+  static float bf16_to_float(uint16 half){
+    return bits_float(static_cast<uint32>(half) << 16);
+  }
+
+  /**
+   * @brief      Widens the given number of half precision numbers from a little endian byte array,
+   *             with the F16C instructions in case the CPU supports them
+   *
+   * @param[in]  table   The 16 bit numbers
+   * @param[in]  count   The number of numbers to convert
+   * @param      values  The buffer for the converted numbers, of at least @count elements
+   */
+  static void fp16_to_floats(const char* table, uint32 count, float* values);
+
+  /**
+   * @brief      Narrows the given number of floats into half precision numbers in a little endian byte array,
+   *             with the F16C instructions in case the CPU supports them
+   *
+   * @param[in]  values  The numbers to convert
+   * @param[in]  count   The number of numbers to convert
+   * @param      table   The buffer for the 16 bit numbers, of at least 2 * @count bytes
+   */
+  static void fp16_from_floats(const float* values, uint32 count, char* table);
+
+  /**
+   * @brief      Tells if the CPU running the library supports the F16C instructions, used by the array conversions
+   */
+  static bool has_f16c(void);
+
+  /**
+   * @brief      Reads a 16 bit number under the given index of a little endian byte array
+   */
+  static uint16 get_half(const char* table, uint32 index){
+    return static_cast<uint8>(table[2 * index]) | (static_cast<uint16>(static_cast<uint8>(table[2 * index + 1])) << 8);
+  }
+
+  /**
+   * @brief      Converts a weight into the given 16 bit format
+   */
+  static uint16 from_double(weight_storages storage, sdouble32 value){
+    if(WEIGHT_STORAGE_BF16 == storage) return bf16_from_float(static_cast<float>(value));
+    else return fp16_from_float(static_cast<float>(value));
+  }
+
+  /**
+   * @brief      Widens a weight of the given 16 bit format
+   */
+  template<weight_storages storage>
+  static sdouble32 to_double(uint16 half){
+    if(WEIGHT_STORAGE_BF16 == storage) return bf16_to_float(half);
+    else return fp16_to_float(half);
+  }
+
+  /**
+   * @brief      Gives the largest relative error of storing a normal number in the given format
+   */
+  static sdouble32 get_relative_precision(weight_storages storage){
+    switch(storage){
+      case WEIGHT_STORAGE_FP16: return 1.0 / 2048.0; /* 2^-11 */
+      case WEIGHT_STORAGE_BF16: return 1.0 / 256.0; /* 2^-8 */
+      default: return 0.0;
+    }
+  }
+
+  /**
+   * @brief      Converts the weights of a @Partial_solution into the given format. The weights are moved
+   *             from @weight_table into @half_weight_table, or back in case the format is double;
+   *             converting back doesn't restore the precision lost by the 16 bit format.
+   *
+   * @param      partial  The partial solution to convert
+   * @param[in]  storage  The format to store the weights in
+   */
+  static void store_weight_table(Partial_solution& partial, weight_storages storage);
+
+private:
+  static void fp16_to_floats_f16c(const char* table, uint32 count, float* values);
+  static void fp16_from_floats_f16c(const float* values, uint32 count, char* table);
+
+  static uint32 float_bits(float value){
+    uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  static float bits_float(uint32 bits){
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static uint32 round_to_nearest_even(uint32 truncated, uint32 remainder, uint32 halfway){
+    if((halfway < remainder)||((halfway == remainder)&&(0u != (truncated & 1u)))) return truncated + 1u;
+    else return truncated;
+  }
+};
+
+} /* namespace sparse_net_library */
+#endif /* HALF_FLOAT_H */
@@ -0,0 +1,144 @@
+#ifndef HUGE_PAGE_STORAGE_H
+#define HUGE_PAGE_STORAGE_H
+
+#include "sparse_net_global.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <google/protobuf/arena.h>
+
+#include "models/aligned_allocator.h"
+
+namespace sparse_net_library{
+
+using std::shared_ptr;
+
+/**
+ * @brief      The kind of pages a buffer is stored in
+ */
+enum class Page_backing : uint8{
+  regular_pages,
+  advised_huge_pages, /* The buffer is advised to the kernel to be backed by transparent huge pages, but it is not */
+  transparent_huge_pages, /* The buffer is backed by transparent huge pages, as reported by /proc/self/smaps */
+  explicit_huge_pages /* The buffer is mapped from the reserved huge pages of the system */
+};
+
+/**
+ * @brief      Allocates large buffers in huge pages, to reduce the TLB misses when they are iterated through.
+ *             First explicit huge pages are tried (MAP_HUGETLB), which are only available when the system has
+ *             huge pages reserved; then a mapping aligned to huge pages and advised for transparent huge pages
+ *             (MADV_HUGEPAGE), which is only reported to be in huge pages once the kernel backs it with them;
+ *             buffers smaller than a huge page, or on systems without either, are stored in regular cache line aligned memory.
+ *             Whether a buffer is mapped depends only on its size, so it can be freed based on its size as well.
+ */
+class Huge_page_storage{
+public:
+  static const std::size_t huge_page_bytes = 2 * 1024 * 1024;
+
+  /**
+   * @brief      Allocates a buffer of the given size
+   *
+   * @param[in]  bytes         The size of the buffer
+   * @param[in]  huge_pages    Whether to try to store the buffer in huge pages
+   * @param      backing       The kind of pages the buffer ended up stored in
+   * @param[in]  page_aligned  Whether a buffer in regular memory shall be stored in whole pages of its own,
+   *                           e.g. so it can be moved between NUMA nodes without moving other data with it
+   *
+   * @return     The allocated buffer; throws std::bad_alloc in case it can't be allocated
+   */
+  static void* allocate(std::size_t bytes, bool huge_pages, Page_backing& backing, bool page_aligned = false);
+
+  /**
+   * @brief      Frees a buffer allocated by @allocate with the same size and huge page option
+   */
+  static void deallocate(void* data, std::size_t bytes, bool huge_pages);
+
+  /**
+   * @brief      Gets the options of a protobuf Arena storing its blocks in huge pages; so the messages
+   *             placed into it, e.g. the weight tables of a @Solution, are stored in huge pages as well.
+   *             The blocks of the arena are at least one huge page in size.
+   */
+  static google::protobuf::ArenaOptions arena_options(void);
+
+  /**
+   * @brief      Gets the number of bytes in the blocks of the arenas created with @arena_options
+   *             currently stored in huge pages, either transparent or explicit
+   */
+  static uint64 get_arena_bytes_in_huge_pages(void);
+
+  /**
+   * @brief      Gets the number of bytes backed by transparent huge pages in the mappings of the process overlapping
+   *             the given memory, based on the AnonHugePages of /proc/self/smaps; 0 in case it is not available
+   */
+  static std::size_t get_transparent_huge_page_bytes(const void* data, std::size_t bytes);
+
+private:
+  static void* allocate_arena_block(std::size_t bytes);
+  static void deallocate_arena_block(void* data, std::size_t bytes);
+  static bool is_mapped(std::size_t bytes, bool huge_pages);
+
+  static std::mutex arena_blocks_mutex;
+  static std::unordered_map<void*, Page_backing> arena_block_backings; /* The pages of the blocks of the arenas */
+  static uint64 arena_bytes_in_huge_pages;
+};
+
+/**
+ * @brief      An allocator for standard containers storing their data through @Huge_page_storage.
+ *             The kind of pages the latest allocation of the allocator and its copies got is
+ *             recorded into a shared @Page_backing, so the owner of the container can report it.
+ */
+template<typename T>
+class Huge_page_allocator{
+public:
+  typedef T value_type;
+
+  Huge_page_allocator(bool huge_pages_ = false, bool page_aligned_ = false)
+  : huge_pages(huge_pages_), page_aligned(page_aligned_)
+  , backing(std::make_shared<Page_backing>(Page_backing::regular_pages))
+  { }
+
+  template<typename U>
+  Huge_page_allocator(const Huge_page_allocator<U>& other)
+  : huge_pages(other.huge_pages), page_aligned(other.page_aligned), backing(other.backing)
+  { }
+
+  T* allocate(std::size_t number_of_elements){
+    return static_cast<T*>(Huge_page_storage::allocate(number_of_elements * sizeof(T), huge_pages, *backing, page_aligned));
+  }
+
+  void deallocate(T* data, std::size_t number_of_elements){
+    Huge_page_storage::deallocate(data, number_of_elements * sizeof(T), huge_pages);
+  }
+
+  /**
+   * @brief      Gets the kind of pages the latest allocation is stored in
+   */
+  Page_backing get_backing(void) const{
+    return *backing;
+  }
+
+private:
+  template<typename U> friend class Huge_page_allocator;
+  template<typename U, typename V>
+  friend bool operator==(const Huge_page_allocator<U>&, const Huge_page_allocator<V>&);
+
+  bool huge_pages;
+  bool page_aligned; /* Whether the buffers not in huge pages are stored in whole pages of their own */
+  shared_ptr<Page_backing> backing;
+};
+
+template<typename T, typename U>
+bool operator==(const Huge_page_allocator<T>& first, const Huge_page_allocator<U>& second){
+  return ((first.huge_pages == second.huge_pages)&&(first.page_aligned == second.page_aligned));
+}
+
+template<typename T, typename U>
+bool operator!=(const Huge_page_allocator<T>& first, const Huge_page_allocator<U>& second){
+  return !(first == second);
+}
+
+} /* namespace sparse_net_library */
+
+#endif /* HUGE_PAGE_STORAGE_H */
@@ -0,0 +1,42 @@
+#ifndef INPUT_TRANSFORMER_H
+#define INPUT_TRANSFORMER_H
+
+#include <cmath>
+#include <algorithm>
+
+#include "sparse_net_global.h"
+#include "gen/common.pb.h"
+
+namespace sparse_net_library{
+
+/**
+ * @brief      Applying the preprocessing of the network inputs
+ */
+class Input_transformer{
+public:
+  /**
+   * @brief      Apply the given transformation to an input
+   *
+   * @param[in]  transform  The transformation of the input
+   * @param[in]  input      The raw input
+   *
+   * @return     The scaled, shifted and clipped input
+   */
+  static sdouble32 get_value(const Input_transform& transform, sdouble32 input){
+    return std::min(std::max((input * transform.scale()) + transform.offset(), transform.min_value()), transform.max_value());
+  }
+
+  /**
+   * @brief      Determines if the given transformation gives a finite number for every finite input
+   */
+  static bool is_valid(const Input_transform& transform){
+    return (
+      (std::isfinite(transform.scale()))&&(std::isfinite(transform.offset()))
+      &&(!std::isnan(transform.min_value()))&&(!std::isnan(transform.max_value()))
+      &&(transform.min_value() <= transform.max_value())
+    );
+  }
+};
+
+} /* namespace sparse_net_library */
+#endif /* INPUT_TRANSFORMER_H */
@@ -0,0 +1,100 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+namespace sparse_net_library{
+
+using std::vector;
+using std::unique_ptr;
+
+/**
+ * @brief      Describes the NUMA nodes of a machine: the CPUs of every node, and places memory onto them.
+ *             The topology is either detected from the system, or simulated by giving the CPUs of every node,
+ *             so NUMA aware placement can be exercised on single node machines as well. Memory is moved
+ *             between nodes only on a detected topology of multiple nodes, but the bytes requested to be
+ *             placed onto every node are counted in either case.
+ */
+class Numa_topology{
+public:
+  /**
+   * @brief      Constructs a simulated topology
+   *
+   * @param[in]  node_cpus_  The CPUs of every node
+   */
+  Numa_topology(vector<vector<uint32>> node_cpus_)
+  : node_cpus(std::move(node_cpus_)), simulated(true)
+  , placed_bytes(node_cpus.size(), 0)
+  {
+    if(0 == node_cpus.size()) throw "A NUMA topology of 0 nodes!";
+    for(uint32 node_index = 0; node_index < node_cpus.size(); ++node_index)
+      node_ids.push_back(node_index);
+  }
+
+  /**
+   * @brief      Detects the topology of the system from /sys/devices/system/node; in case it is not
+   *             available, the system is described as one node with every CPU in it.
+   *
+   * @return     The detected topology
+   */
+  static unique_ptr<Numa_topology> detect(void);
+
+  uint16 get_number_of_nodes(void) const{
+    return node_cpus.size();
+  }
+
+  const vector<uint32>& get_node_cpus(uint16 node) const{
+    return node_cpus[node];
+  }
+
+  bool is_simulated(void) const{
+    return simulated;
+  }
+
+  /**
+   * @brief      Moves the pages containing the given memory onto the given node. Since whole pages are moved,
+   *             data sharing a page with the given memory is moved as well. Failing to move pages
+   *             is not an error, as the placement only affects performance.
+   *
+   * @param[in]  data   The start of the memory
+   * @param[in]  bytes  The size of the memory
+   * @param[in]  node   The index of the node
+   */
+  void place_on_node(const void* data, std::size_t bytes, uint16 node) const;
+
+  /**
+   * @brief      Gets the number of bytes requested to be placed onto the given node so far
+   */
+  uint64 get_placed_bytes(uint16 node) const{
+    std::lock_guard<std::mutex> my_lock(placed_bytes_mutex);
+    return placed_bytes[node];
+  }
+
+  /**
+   * @brief      Pins the calling thread to the given CPUs. CPUs unknown to the system are ignored;
+   *             in case none of them are known, the thread is not pinned.
+   *
+   * @param[in]  cpus  The CPUs
+   *
+   * @return     True if the thread is pinned
+   */
+  static bool pin_current_thread(const vector<uint32>& cpus);
+
+private:
+  Numa_topology() = default;
+
+  vector<vector<uint32>> node_cpus;
+  vector<sint32> node_ids; /* The identifiers of the nodes in the system */
+  bool simulated = false;
+  mutable std::mutex placed_bytes_mutex;
+  mutable vector<uint64> placed_bytes;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* NUMA_TOPOLOGY_H */
@@ -0,0 +1,96 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace sparse_net_library{
+
+using std::vector;
+
+/**
+ * @brief      A queue stored in a circular buffer, which can be taken from both ends. Unlike std::deque,
+ *             it allocates only when it has to grow above its largest size so far, so a queue with a steady
+ *             number of elements runs without any heap allocations. Not thread-safe.
+ */
+template<typename T>
+class Ring_buffer{
+public:
+  Ring_buffer(uint32 initial_capacity = 16)
+  : elements(std::max(1u, initial_capacity))
+  { }
+
+  void push_back(T element){
+    if(number_of_elements == elements.size()) grow();
+    elements[(first_element + number_of_elements) % elements.size()] = std::move(element);
+    ++number_of_elements;
+  }
+
+  T& front(void){
+    return elements[first_element];
+  }
+
+  const T& front(void) const{
+    return elements[first_element];
+  }
+
+  /**
+   * @brief      Removes the first element; the stored object is moved out, so it doesn't keep any resources
+   */
+  void pop_front(void){
+    T removed = std::move(elements[first_element]);
+    first_element = (first_element + 1) % elements.size();
+    --number_of_elements;
+  }
+
+  T& back(void){
+    return (*this)[number_of_elements - 1];
+  }
+
+  const T& back(void) const{
+    return (*this)[number_of_elements - 1];
+  }
+
+  /**
+   * @brief      Removes the last element; the stored object is moved out, so it doesn't keep any resources
+   */
+  void pop_back(void){
+    T removed = std::move(back());
+    --number_of_elements;
+  }
+
+  /**
+   * @brief      Access to the elements in FIFO order: index 0 is the front of the queue
+   */
+  T& operator[](uint32 index){
+    return elements[(first_element + index) % elements.size()];
+  }
+
+  const T& operator[](uint32 index) const{
+    return elements[(first_element + index) % elements.size()];
+  }
+
+  uint32 size(void) const{
+    return number_of_elements;
+  }
+
+private:
+  void grow(void){
+    vector<T> grown_elements(elements.size() * 2);
+    for(uint32 element_iterator = 0; element_iterator < number_of_elements; ++element_iterator)
+      grown_elements[element_iterator] = std::move((*this)[element_iterator]);
+    elements.swap(grown_elements);
+    first_element = 0;
+  }
+
+  vector<T> elements;
+  uint32 first_element = 0;
+  uint32 number_of_elements = 0;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* RING_BUFFER_H */
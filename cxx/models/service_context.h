@@ -3,11 +3,14 @@
 
 #include "sparse_net_global.h"
 #include "gen/common.pb.h"
+#include "models/numa_topology.h"
 
 namespace sparse_net_library{
 
 using google::protobuf::Arena;
 
+class Worker_pool;
+
 class Service_context{
 public:
   uint16 get_max_solve_threads() const{
@@ -26,6 +29,26 @@ public:
     return arena_ptr;
   }
 
+  bool get_checked_solve() const{
+    return checked_solve;
+  }
+
+  bool get_cache_aligned_partials() const{
+    return cache_aligned_partials;
+  }
+
+  bool get_huge_page_storage() const{
+    return huge_page_storage;
+  }
+
+  const Numa_topology* get_numa_topology() const{
+    return numa_topology;
+  }
+
+  Worker_pool* get_worker_pool() const{
+    return worker_pool;
+  }
+
   Service_context& set_max_solve_threads(sdouble32 max_solve_threads_){
     max_solve_threads = max_solve_threads_;
     return *this;
@@ -45,11 +68,65 @@ public:
     arena_ptr = arena_ptr_;
     return *this;
   }
+
+  /**
+   * @brief      Sets whether solvers shall verify every data access while solving, instead of
+   *             verifying the structure only once at construction. Useful for debugging.
+   */
+  Service_context& set_checked_solve(bool checked_solve_){
+    checked_solve = checked_solve_;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets whether the outputs of the partial solutions solved in parallel shall be placed
+   *             into separate cache lines, so the threads writing them don't contend for the same lines.
+   *             Costs some padding in the Neuron data of the solvers.
+   */
+  Service_context& set_cache_aligned_partials(bool cache_aligned_partials_){
+    cache_aligned_partials = cache_aligned_partials_;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets whether the large buffers of the solvers shall be stored in huge pages, when the system
+   *             provides them, to reduce TLB misses while solving. The weights of a @Solution can be stored
+   *             in huge pages by building it into an Arena created with @Huge_page_storage::arena_options.
+   */
+  Service_context& set_huge_page_storage(bool huge_page_storage_){
+    huge_page_storage = huge_page_storage_;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets the NUMA topology the solvers shall place their workers and data by. The workers are pinned
+   *             to the nodes, and every partial solution is solved on one node, with its data placed onto that node.
+   *             The topology shall outlive the solvers using it; without it, the solvers are not NUMA aware.
+   */
+  Service_context& set_numa_topology(const Numa_topology* numa_topology_){
+    numa_topology = numa_topology_;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets the pool of worker threads the solvers shall solve on, instead of starting their own.
+   *             Solvers sharing a pool interleave their work on the same threads. The pool shall outlive
+   *             the solvers using it; the number of its workers overrides the maximum number of solve threads.
+   */
+  Service_context& set_worker_pool(Worker_pool* worker_pool_){
+    worker_pool = worker_pool_;
+    return *this;
+  }
 private:
   uint16 max_solve_threads = 16;
   uint16 max_processing_threads = 32;
   sdouble32 device_max_megabytes = 2048.0;
   Arena* arena_ptr = nullptr;
+  bool checked_solve = false;
+  bool cache_aligned_partials = true;
+  bool huge_page_storage = false;
+  const Numa_topology* numa_topology = nullptr;
+  Worker_pool* worker_pool = nullptr;
 };
 
 } /* namespace sparse_net_library */
@@ -0,0 +1,116 @@
+#include "models/half_float.h"
+
+#include <vector>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_FLOAT_F16C_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace sparse_net_library {
+
+using std::vector;
+
+bool Half_float::has_f16c(void){
+#if defined(__F16C__)
+  return true;
+#elif defined(HALF_FLOAT_F16C_DISPATCH)
+  static const bool supported = (__builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx"));
+  return supported;
+#else
+  return false;
+#endif
+}
+
+void Half_float::fp16_to_floats(const char* table, uint32 count, float* values){
+  if(has_f16c()) fp16_to_floats_f16c(table, count, values);
+  else for(uint32 value_index = 0; value_index < count; ++value_index)
+    values[value_index] = fp16_to_float(get_half(table, value_index));
+}
+
+void Half_float::fp16_from_floats(const float* values, uint32 count, char* table){
+  if(has_f16c()){
+    fp16_from_floats_f16c(values, count, table);
+  }else for(uint32 value_index = 0; value_index < count; ++value_index){
+    const uint16 half = fp16_from_float(values[value_index]);
+    table[2 * value_index] = static_cast<char>(half & 0xFFu);
+    table[2 * value_index + 1] = static_cast<char>(half >> 8);
+  }
+}
+
+#if defined(HALF_FLOAT_F16C_DISPATCH)
+__attribute__((target("avx,f16c")))
+void Half_float::fp16_to_floats_f16c(const char* table, uint32 count, float* values){
+  uint32 value_index = 0;
+  for(; (value_index + 8) <= count; value_index += 8) /* The bytes are little endian, as the 16 bit lanes of the CPU */
+    _mm256_storeu_ps(values + value_index, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 2 * value_index))));
+  for(; value_index < count; ++value_index)
+    values[value_index] = _cvtsh_ss(get_half(table, value_index));
+}
+
+__attribute__((target("avx,f16c")))
+void Half_float::fp16_from_floats_f16c(const float* values, uint32 count, char* table){
+  uint32 value_index = 0;
+  for(; (value_index + 8) <= count; value_index += 8){
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(table + 2 * value_index),
+      _mm256_cvtps_ph(_mm256_loadu_ps(values + value_index), _MM_FROUND_TO_NEAREST_INT)
+    );
+  }
+  for(; value_index < count; ++value_index){
+    const uint16 half = _cvtss_sh(values[value_index], _MM_FROUND_TO_NEAREST_INT);
+    table[2 * value_index] = static_cast<char>(half & 0xFFu);
+    table[2 * value_index + 1] = static_cast<char>(half >> 8);
+  }
+}
+#else
+void Half_float::fp16_to_floats_f16c(const char*, uint32, float*){
+  throw "F16C conversion without F16C support!";
+}
+
+void Half_float::fp16_from_floats_f16c(const float*, uint32, char*){
+  throw "F16C conversion without F16C support!";
+}
+#endif
+
+void Half_float::store_weight_table(Partial_solution& partial, weight_storages storage){
+  if(!weight_storages_IsValid(storage)) throw "Unknown weight storage!";
+  if(storage == partial.weight_storage()) return;
+  vector<sdouble32> weights; /* The current weights widened */
+  if(WEIGHT_STORAGE_DOUBLE == partial.weight_storage()){
+    weights.assign(partial.weight_table().begin(), partial.weight_table().end());
+  }else{
+    const std::string& half_weights = partial.half_weight_table();
+    const uint32 number_of_weights = half_weights.size() / sizeof(uint16);
+    if(WEIGHT_STORAGE_FP16 == partial.weight_storage()){
+      vector<float> widened_weights(number_of_weights);
+      fp16_to_floats(half_weights.data(), number_of_weights, widened_weights.data());
+      weights.assign(widened_weights.begin(), widened_weights.end());
+    }else{
+      weights.resize(number_of_weights);
+      for(uint32 weight_index = 0; weight_index < number_of_weights; ++weight_index)
+        weights[weight_index] = bf16_to_float(get_half(half_weights.data(), weight_index));
+    }
+  }
+
+  partial.clear_weight_table();
+  partial.clear_half_weight_table();
+  if(WEIGHT_STORAGE_DOUBLE == storage){
+    *partial.mutable_weight_table() = {weights.begin(), weights.end()};
+  }else{
+    std::string half_weights(weights.size() * sizeof(uint16), '\0');
+    if(WEIGHT_STORAGE_FP16 == storage){
+      const vector<float> narrowed_weights(weights.begin(), weights.end());
+      fp16_from_floats(narrowed_weights.data(), narrowed_weights.size(), &half_weights[0]);
+    }else for(uint32 weight_index = 0; weight_index < weights.size(); ++weight_index){
+      const uint16 half = from_double(storage, weights[weight_index]);
+      half_weights[2 * weight_index] = static_cast<char>(half & 0xFFu);
+      half_weights[2 * weight_index + 1] = static_cast<char>(half >> 8);
+    }
+    partial.set_half_weight_table(half_weights);
+  }
+  partial.set_weight_storage(storage);
+}
+
+} /* namespace sparse_net_library */
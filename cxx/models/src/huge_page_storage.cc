@@ -0,0 +1,144 @@
+#include "models/huge_page_storage.h"
+
+#include <new>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace sparse_net_library{
+
+const std::size_t Huge_page_storage::huge_page_bytes;
+std::mutex Huge_page_storage::arena_blocks_mutex;
+std::unordered_map<void*, Page_backing> Huge_page_storage::arena_block_backings;
+uint64 Huge_page_storage::arena_bytes_in_huge_pages = 0;
+
+bool Huge_page_storage::is_mapped(std::size_t bytes, bool huge_pages){
+#if defined(__linux__)
+  return (huge_pages && (huge_page_bytes <= bytes));
+#else
+  return false;
+#endif
+}
+
+void* Huge_page_storage::allocate(std::size_t bytes, bool huge_pages, Page_backing& backing, bool page_aligned){
+  backing = Page_backing::regular_pages;
+  if((!is_mapped(bytes, huge_pages))&&(page_aligned)) /* Rounded up to whole pages, so no other data shares the last one */
+    return Aligned_allocator<uint8, page_bytes>().allocate(((bytes + page_bytes - 1) / page_bytes) * page_bytes);
+  if(!is_mapped(bytes, huge_pages))
+    return Aligned_allocator<uint8>().allocate(bytes);
+
+#if defined(__linux__)
+  const std::size_t mapped_bytes = ((bytes + huge_page_bytes - 1) / huge_page_bytes) * huge_page_bytes;
+  void* data = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  data = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if(MAP_FAILED != data){
+    backing = Page_backing::explicit_huge_pages;
+    return data;
+  } /* No huge pages reserved in the system */
+#endif
+  data = mmap( /* Mapped with an extra huge page, so the mapping can be trimmed to start at a huge page */
+    nullptr, mapped_bytes + huge_page_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+  );
+  if(MAP_FAILED == data) throw std::bad_alloc();
+  const std::uintptr_t mapping_start = reinterpret_cast<std::uintptr_t>(data);
+  const std::uintptr_t aligned_start = ((mapping_start + huge_page_bytes - 1) / huge_page_bytes) * huge_page_bytes;
+  if(mapping_start < aligned_start) munmap(data, aligned_start - mapping_start);
+  if((aligned_start - mapping_start) < huge_page_bytes)
+    munmap(reinterpret_cast<void*>(aligned_start + mapped_bytes), huge_page_bytes - (aligned_start - mapping_start));
+  data = reinterpret_cast<void*>(aligned_start);
+#if defined(MADV_HUGEPAGE)
+  if(0 == madvise(data, mapped_bytes, MADV_HUGEPAGE)){
+    backing = Page_backing::advised_huge_pages;
+    for(std::size_t page_start = 0; page_start < mapped_bytes; page_start += huge_page_bytes)
+      static_cast<volatile uint8*>(data)[page_start] = 0; /* The kernel decides the pages on the first touch */
+    if(mapped_bytes <= get_transparent_huge_page_bytes(data, mapped_bytes))
+      backing = Page_backing::transparent_huge_pages;
+  }
+#endif
+  return data;
+#else
+  return nullptr;
+#endif
+}
+
+void Huge_page_storage::deallocate(void* data, std::size_t bytes, bool huge_pages){
+  if(!is_mapped(bytes, huge_pages)){
+    Aligned_allocator<uint8>().deallocate(static_cast<uint8*>(data), bytes);
+  }else{
+#if defined(__linux__)
+    munmap(data, ((bytes + huge_page_bytes - 1) / huge_page_bytes) * huge_page_bytes);
+#endif
+  }
+}
+
+std::size_t Huge_page_storage::get_transparent_huge_page_bytes(const void* data, std::size_t bytes){
+  std::ifstream smaps("/proc/self/smaps");
+  const std::uintptr_t data_start = reinterpret_cast<std::uintptr_t>(data);
+  std::size_t huge_page_bytes_in_mappings = 0;
+  bool overlapping = false;
+  std::string line;
+  while(std::getline(smaps, line)){
+    std::istringstream fields(line);
+    std::string first_field;
+    fields >> first_field;
+    if(first_field.empty()) continue;
+    if(':' != first_field.back()){ /* The address range of the next mapping, e.g. "7f0000000000-7f0000400000" */
+      const std::size_t separator = first_field.find('-');
+      if(std::string::npos == separator) continue;
+      const std::uintptr_t mapping_start = std::stoull(first_field.substr(0, separator), nullptr, 16);
+      const std::uintptr_t mapping_end = std::stoull(first_field.substr(separator + 1), nullptr, 16);
+      overlapping = ((mapping_start < (data_start + bytes))&&(data_start < mapping_end));
+    }else if(overlapping && ("AnonHugePages:" == first_field)){
+      std::size_t kilobytes = 0;
+      fields >> kilobytes;
+      huge_page_bytes_in_mappings += kilobytes * 1024;
+    }
+  }
+  return huge_page_bytes_in_mappings;
+}
+
+google::protobuf::ArenaOptions Huge_page_storage::arena_options(void){
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = huge_page_bytes;
+  options.max_block_size = huge_page_bytes;
+  options.block_alloc = &allocate_arena_block;
+  options.block_dealloc = &deallocate_arena_block;
+  return options;
+}
+
+uint64 Huge_page_storage::get_arena_bytes_in_huge_pages(void){
+  std::lock_guard<std::mutex> my_lock(arena_blocks_mutex);
+  return arena_bytes_in_huge_pages;
+}
+
+void* Huge_page_storage::allocate_arena_block(std::size_t bytes){
+  Page_backing backing;
+  void* block = allocate(bytes, true, backing);
+  std::lock_guard<std::mutex> my_lock(arena_blocks_mutex);
+  arena_block_backings[block] = backing;
+  if((Page_backing::transparent_huge_pages == backing)||(Page_backing::explicit_huge_pages == backing))
+    arena_bytes_in_huge_pages += bytes;
+  return block;
+}
+
+void Huge_page_storage::deallocate_arena_block(void* data, std::size_t bytes){
+  {
+    std::lock_guard<std::mutex> my_lock(arena_blocks_mutex);
+    std::unordered_map<void*, Page_backing>::iterator block = arena_block_backings.find(data);
+    if(arena_block_backings.end() != block){
+      if((Page_backing::transparent_huge_pages == block->second)||(Page_backing::explicit_huge_pages == block->second))
+        arena_bytes_in_huge_pages -= bytes;
+      arena_block_backings.erase(block);
+    }
+  }
+  deallocate(data, bytes, true);
+}
+
+} /* namespace sparse_net_library */
@@ -0,0 +1,98 @@
+#include "models/numa_topology.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace sparse_net_library{
+
+namespace{
+
+/**
+ * @brief      Parses a CPU list of the form "0-3,8,10-11"
+ */
+vector<uint32> parse_cpu_list(const std::string& cpu_list){
+  vector<uint32> cpus;
+  std::stringstream ranges(cpu_list);
+  std::string range;
+  while(std::getline(ranges, range, ',')){
+    if(range.empty() || ('\n' == range[0])) continue;
+    const std::size_t separator = range.find('-');
+    const uint32 first_cpu = std::stoul(range.substr(0, separator));
+    const uint32 last_cpu = (std::string::npos == separator)?(first_cpu):(std::stoul(range.substr(separator + 1)));
+    for(uint32 cpu = first_cpu; cpu <= last_cpu; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+} /* namespace */
+
+unique_ptr<Numa_topology> Numa_topology::detect(void){
+  unique_ptr<Numa_topology> topology(new Numa_topology());
+  for(sint32 node_id = 0; node_id < 1024; ++node_id){ /* Node identifiers may have gaps, so every possible one is checked */
+    std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(node_id) + "/cpulist");
+    if(!cpu_list_file.is_open()) continue;
+    std::string cpu_list;
+    std::getline(cpu_list_file, cpu_list);
+    vector<uint32> cpus = parse_cpu_list(cpu_list);
+    if(0 == cpus.size()) continue; /* Memory only nodes don't run workers */
+    topology->node_cpus.push_back(std::move(cpus));
+    topology->node_ids.push_back(node_id);
+  }
+  if(0 == topology->node_cpus.size()){
+    topology->node_cpus.push_back(vector<uint32>());
+    for(uint32 cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+      topology->node_cpus[0].push_back(cpu);
+    topology->node_ids.push_back(0);
+  }
+  topology->placed_bytes = vector<uint64>(topology->node_cpus.size(), 0);
+  return topology;
+}
+
+void Numa_topology::place_on_node(const void* data, std::size_t bytes, uint16 node) const{
+  {
+    std::lock_guard<std::mutex> my_lock(placed_bytes_mutex);
+    placed_bytes[node] += bytes;
+  }
+#if defined(__linux__) && defined(SYS_move_pages)
+  if((!simulated) && (1 < node_cpus.size()) && (0 < bytes)){
+    const std::size_t page_bytes = sysconf(_SC_PAGESIZE);
+    const std::size_t first_page = reinterpret_cast<std::size_t>(data) / page_bytes;
+    const std::size_t last_page = (reinterpret_cast<std::size_t>(data) + bytes - 1) / page_bytes;
+    vector<void*> pages;
+    for(std::size_t page = first_page; page <= last_page; ++page)
+      pages.push_back(reinterpret_cast<void*>(page * page_bytes));
+    vector<int> nodes(pages.size(), node_ids[node]);
+    vector<int> status(pages.size(), 0);
+    const int move_pages_flag_move = 2; /* MPOL_MF_MOVE: only move the pages used only by this process */
+    syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(), move_pages_flag_move);
+  }
+#endif
+}
+
+bool Numa_topology::pin_current_thread(const vector<uint32>& cpus){
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for(uint32 cpu : cpus)
+    if(cpu < CPU_SETSIZE) CPU_SET(cpu, &cpu_set);
+  cpu_set_t available_cpus;
+  if(0 != sched_getaffinity(0, sizeof(available_cpus), &available_cpus)) return false;
+  CPU_AND(&cpu_set, &cpu_set, &available_cpus);
+  if(0 == CPU_COUNT(&cpu_set)) return false;
+  return (0 == pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set));
+#else
+  return false;
+#endif
+}
+
+} /* namespace sparse_net_library */
@@ -0,0 +1,218 @@
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <google/protobuf/repeated_field.h>
+
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+using google::protobuf::RepeatedPtrField;
+using google::protobuf::RepeatedField;
+
+/**
+ * @brief      Plans the storage of the Neuron data used while solving a @Solution. The data of a Neuron
+ *             is only needed from the row calculating it until the last row taking it as input, so
+ *             every Neuron is assigned a slot in the Neuron data buffer only for that lifetime; after that
+ *             the slot is reused by Neurons calculated in later rows. Only the output Neurons keep their slots
+ *             for the whole solution. The Neurons of every @Partial_solution are placed into one continuous range
+ *             starting at a multiple of the slot alignment, and padded to it; with an alignment of one cache line
+ *             the @Partial_solution elements solved in parallel never write into the same cache line.
+ *             The planner provides the inputs and outputs of every @Partial_solution mapped into the slots
+ *             of the buffer. It also plans the input of every row: the union of the network inputs and Neuron slots
+ *             read by the @Partial_solution elements of the row, to be gathered into one buffer once before the row
+ *             is solved; the inside indices of the @Partial_solution elements are mapped to point into it. Since
+ *             a row doesn't read the slots after gathering its input, the Neurons calculated in the row can take
+ *             the slots of the Neurons read last by it. Neurons read by delayed inputs keep their slots for the whole
+ *             solution as well, so their data can be kept for the next run: each of them is assigned a past index, and
+ *             delayed inputs are mapped to these indices, gathered into the row input after the Neuron slots.
+ *             It expects a @Solution already verified by the @Solution_solver.
+ */
+class Memory_planner{
+public:
+  Memory_planner(const Solution& solution, uint32 slot_alignment = 1);
+
+  /**
+   * @brief      Gets the number of elements the Neuron data buffer needs to have
+   *
+   * @return     The size of the Neuron data buffer.
+   */
+  uint32 get_neuron_data_size(void) const{
+    return neuron_data_size;
+  }
+
+  /**
+   * @brief      Gets the slot of the given Neuron in the Neuron data buffer
+   *
+   * @param[in]  neuron_index  The neuron index
+   *
+   * @return     The slot, or @no_slot in case the Neuron is not calculated by any @Partial_solution
+   */
+  uint32 get_slot(uint32 neuron_index) const{
+    return neuron_slot[neuron_index];
+  }
+
+  /**
+   * @brief      Gets the slots of the output Neurons, in the order of the outputs
+   *
+   * @return     The slot synapses of the output Neurons
+   */
+  const RepeatedPtrField<Synapse_interval>& get_output_slots(void) const{
+    return output_slots;
+  }
+
+  /**
+   * @brief      Gets the slots of the Neurons read by delayed inputs, in the order of their past indices
+   *
+   * @return     The slot synapses of the Neurons whose data is kept for the next run
+   */
+  const RepeatedPtrField<Synapse_interval>& get_past_slots(void) const{
+    return past_slots;
+  }
+
+  /**
+   * @brief      Gets the input synapses of a @Partial_solution, with Neuron indices mapped to slots
+   *             of the Neuron data buffer. Network input intervals are kept as they are, delayed intervals
+   *             are mapped to the past indices of the Neurons.
+   *
+   * @param[in]  partial_index  The index of the @Partial_solution inside the @Solution
+   *
+   * @return     The mapped input synapses
+   */
+  const RepeatedPtrField<Synapse_interval>& get_partial_inputs(uint32 partial_index) const{
+    return partial_inputs[partial_index];
+  }
+
+  /**
+   * @brief      Gets the output synapses of a @Partial_solution, with Neuron indices mapped to slots
+   *             of the Neuron data buffer.
+   *
+   * @param[in]  partial_index  The index of the @Partial_solution inside the @Solution
+   *
+   * @return     The mapped output synapses
+   */
+  const RepeatedPtrField<Synapse_interval>& get_partial_outputs(uint32 partial_index) const{
+    return partial_outputs[partial_index];
+  }
+
+  /**
+   * @brief      Gets the inputs of a row: network input intervals followed by Neuron slot intervals,
+   *             and the delayed intervals of past indices, in the order they are to be gathered into the row input buffer
+   *
+   * @param[in]  row_index  The index of the row
+   *
+   * @return     The synapses of the row input
+   */
+  const RepeatedPtrField<Synapse_interval>& get_row_inputs(uint32 row_index) const{
+    return row_inputs[row_index];
+  }
+
+  /**
+   * @brief      Gets the size of the biggest row input, in number of elements
+   */
+  uint32 get_max_row_input_size(void) const{
+    return max_row_input_size;
+  }
+
+  /**
+   * @brief      Gets the inside indices of a @Partial_solution, with the inputs of the Neurons pointing into the row input
+   *
+   * @param[in]  partial_index  The index of the @Partial_solution inside the @Solution
+   *
+   * @return     The mapped inside indices
+   */
+  const RepeatedPtrField<Synapse_interval>& get_partial_inside_indices(uint32 partial_index) const{
+    return partial_inside_indices[partial_index];
+  }
+
+  /**
+   * @brief      Frees the mapped inside indices of every @Partial_solution, once the solvers reading them
+   *             have packed them; afterwards every @Partial_solution is given empty inside indices
+   */
+  void release_partial_inside_indices(void){
+    partial_inside_indices = vector<RepeatedPtrField<Synapse_interval>>(partial_inside_indices.size());
+  }
+
+  /**
+   * @brief      Gets the number of synapses of every Neuron inside the mapped inside indices of a @Partial_solution
+   *
+   * @param[in]  partial_index  The index of the @Partial_solution inside the @Solution
+   *
+   * @return     The index synapse numbers
+   */
+  const RepeatedField<uint32>& get_partial_index_synapse_numbers(uint32 partial_index) const{
+    return partial_index_synapse_numbers[partial_index];
+  }
+
+  static const uint32 no_slot = std::numeric_limits<uint32>::max();
+
+private:
+  /**
+   * @brief      Rounds the given number of slots up to a multiple of the slot alignment
+   */
+  uint32 aligned(uint32 slots) const{
+    return ((slots + slot_alignment - 1) / slot_alignment) * slot_alignment;
+  }
+
+  /**
+   * @brief      Reserves a continuous range of slots from the released ones, or from the end of the buffer,
+   *             starting at an aligned slot
+   *
+   * @param[in]  size  The number of slots to reserve
+   *
+   * @return     The first reserved slot
+   */
+  uint32 reserve_slots(uint32 size);
+
+  /**
+   * @brief      Releases a continuous range of slots, merging it with the neighbouring released slots
+   *
+   * @param[in]  slot  The first slot of the range
+   * @param[in]  size  The number of slots in the range
+   */
+  void release_slots(uint32 slot, uint32 size);
+
+  /**
+   * @brief      Adds the given synapse interval to the mapped synapses with every Neuron index
+   *             replaced by the slot of the Neuron, or by its past index in case the interval is delayed
+   *
+   * @param[in]  interval  The interval to map
+   * @param      mapped    The mapped synapses to add it to
+   */
+  void map_interval(const Synapse_interval& interval, RepeatedPtrField<Synapse_interval>& mapped) const;
+
+  /**
+   * @brief      Adds an index to the given synapses, extending the last synapse if the index continues it
+   *
+   * @param[in]  index                    The index to add
+   * @param      synapses                 The synapses
+   * @param[in]  first_mergeable_synapse  The synapses before this one are not to be extended
+   * @param[in]  delayed                  Whether the index is a past index; only extends delayed synapses
+   */
+  static void append_index(sint32 index, RepeatedPtrField<Synapse_interval>& synapses, uint32 first_mergeable_synapse, bool delayed = false);
+
+  uint32 slot_alignment;
+  uint32 neuron_data_size = 0;
+  vector<uint32> neuron_slot;
+  vector<uint32> neuron_past_index; /* The index of every Neuron read by delayed inputs among them, or @no_slot */
+  RepeatedPtrField<Synapse_interval> output_slots;
+  RepeatedPtrField<Synapse_interval> past_slots;
+  std::map<uint32,uint32> released_slots; /* Released continuous slot ranges: start and size */
+  vector<RepeatedPtrField<Synapse_interval>> partial_inputs;
+  vector<RepeatedPtrField<Synapse_interval>> partial_outputs;
+  vector<RepeatedPtrField<Synapse_interval>> row_inputs;
+  vector<RepeatedPtrField<Synapse_interval>> partial_inside_indices;
+  vector<RepeatedField<uint32>> partial_index_synapse_numbers;
+  uint32 max_row_input_size = 0;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* MEMORY_PLANNER_H */
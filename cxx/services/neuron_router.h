@@ -26,6 +26,8 @@ using std::atomic;
                If a Neuron is solvable, its state is being set to "reserved", and collected into the subset.
                After an iteration the state update from the subset needs to be handled by whoever has access to
                the Neuron indexes inside.
+               Delayed inputs read the data of the previous run, so they are counted as processed and not followed:
+               they don't order the Neurons, and a Neuron read only through delayed inputs is not collected by itself.
  */
 class Neuron_router{
 public:
@@ -93,9 +95,17 @@ public:
     return net_subset.size();
   }
 
-  void reset_remaining_subset(void){
-    for(uint32 neuron_index : net_subset){
-      confirm_first_subset_element_ommitted(neuron_index);
+  /**
+   * @brief      Omits the Neurons from the subset, except the first given number of elements,
+   *             which are kept in the subset as reserved.
+   *
+   * @param[in]  number_of_kept_elements  The number of elements to keep at the front of the subset
+   */
+  void reset_remaining_subset(uint32 number_of_kept_elements = 0){
+    while(number_of_kept_elements < net_subset.size()){
+      (neuron_states[net_subset.back()])->store(0);
+      net_subset.pop_back();
+      net_subset_index.pop_back();
     }
   }
 
@@ -0,0 +1,131 @@
+#ifndef PACKED_SYNAPSES_H
+#define PACKED_SYNAPSES_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <google/protobuf/repeated_field.h>
+
+#include "gen/common.pb.h"
+#include "services/synapse_iterator.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+using google::protobuf::RepeatedPtrField;
+
+/**
+ * @brief      A compact copy of synapse intervals, iterated the same way as by the @Synapse_iterator.
+ *             Every interval is stored as the distance of its start from the end of the interval before it,
+ *             and its size; both as variable length integers of 7 bits in every byte. So continuous or nearby
+ *             intervals take a few bytes instead of a whole @Synapse_interval message, and the indices are read
+ *             from one continuous buffer. The intervals are packed in sequences, every sequence can be iterated
+ *             by itself from the offset it is packed at. The variable length integers are decoded one byte at a time:
+ *             the library is built for CPUs without BMI2, and dispatching a decoder of a few bytes at run time
+ *             would cost more than the decoding itself.
+ */
+class Packed_synapses{
+public:
+  /**
+   * @brief      Packs the given intervals as a new sequence after the ones already packed
+   *
+   * @param[in]  synapses            The intervals to pack from
+   * @param[in]  first_synapse       The first interval of the sequence
+   * @param[in]  number_of_synapses  The number of intervals in the sequence
+   *
+   * @return     The offset of the sequence in bytes, to iterate it from
+   */
+  uint32 pack(const RepeatedPtrField<Synapse_interval>& synapses, uint32 first_synapse, uint32 number_of_synapses){
+    const uint32 sequence_offset = bytes.size();
+    sint64 previous_end = 0;
+    for(uint32 synapse_iterator = first_synapse; synapse_iterator < (first_synapse + number_of_synapses); ++synapse_iterator){
+      const Synapse_interval& interval = synapses.Get(synapse_iterator);
+      const sint64 distance = static_cast<sint64>(interval.starts()) - previous_end;
+      append_varint((static_cast<uint64>(distance) << 1) ^ static_cast<uint64>(distance >> 63)); /* zigzag, so small negative distances stay small */
+      append_varint(interval.interval_size());
+      previous_end = get_end(interval.starts(), interval.interval_size());
+    }
+    return sequence_offset;
+  }
+
+  /**
+   * @brief      Same as @Synapse_iterator::skim_inline, for the sequence packed at the given offset
+   */
+  template<typename Do_for_each_synapse>
+  void skim_inline(Do_for_each_synapse&& do_for_each_synapse, uint32 sequence_offset, uint32 number_of_synapses) const{
+    const uint8* data = bytes.data() + sequence_offset;
+    sint64 previous_end = 0;
+    for(uint32 synapse_iterator = 0; synapse_iterator < number_of_synapses; ++synapse_iterator){
+      const uint64 zigzag_distance = read_varint(data);
+      const sint32 starts = static_cast<sint32>(previous_end + (static_cast<sint64>(zigzag_distance >> 1) ^ -static_cast<sint64>(zigzag_distance & 1u)));
+      const uint32 interval_size = static_cast<uint32>(read_varint(data));
+      do_for_each_synapse(starts, interval_size);
+      previous_end = get_end(starts, interval_size);
+    }
+  }
+
+  /**
+   * @brief      Same as @Synapse_iterator::iterate_inline, for the sequence packed at the given offset
+   */
+  template<typename Do_for_each_index>
+  void iterate_inline(Do_for_each_index&& do_for_each_index, uint32 sequence_offset, uint32 number_of_synapses) const{
+    skim_inline([&do_for_each_index](sint32 starts, uint32 interval_size){
+      if(!Synapse_iterator::is_index_input(starts)){
+        for(uint32 input_iterator = 0; input_iterator < interval_size; ++input_iterator)
+          do_for_each_index(starts + static_cast<sint32>(input_iterator));
+      }else{ /* current element is from the input, iterate in a negative way */
+        for(uint32 input_iterator = 0; input_iterator < interval_size; ++input_iterator)
+          do_for_each_index(starts - static_cast<sint32>(input_iterator));
+      }
+    }, sequence_offset, number_of_synapses);
+  }
+
+  /**
+   * @brief      Frees the capacity left over after packing every sequence
+   */
+  void shrink_to_fit(void){
+    bytes.shrink_to_fit();
+  }
+
+  /**
+   * @brief      Gets the number of bytes the packed intervals take
+   */
+  uint32 get_size_in_bytes(void) const{
+    return bytes.size();
+  }
+
+private:
+  vector<uint8> bytes;
+
+  /**
+   * @brief      Gets the index after the last one of the interval, in the direction the interval is iterated
+   */
+  static sint64 get_end(sint32 starts, uint32 interval_size){
+    if(Synapse_iterator::is_index_input(starts)) return (static_cast<sint64>(starts) - interval_size);
+      else return (static_cast<sint64>(starts) + interval_size);
+  }
+
+  void append_varint(uint64 value){
+    while(0x80u <= value){
+      bytes.push_back(static_cast<uint8>(value | 0x80u));
+      value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8>(value));
+  }
+
+  static uint64 read_varint(const uint8*& data){
+    uint64 value = 0;
+    uint32 shift = 0;
+    uint8 byte;
+    do{
+      byte = *data++;
+      value |= static_cast<uint64>(byte & 0x7Fu) << shift;
+      shift += 7;
+    }while(0u != (byte & 0x80u));
+    return value;
+  }
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* PACKED_SYNAPSES_H */
@@ -7,6 +7,9 @@
 #include "services/synapse_iterator.h"
 
 #include <functional>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
 
 namespace sparse_net_library{
 
@@ -15,6 +18,9 @@ using google::protobuf::RepeatedPtrField;
 
 /**
  * @brief      Front-end to create partial solution objects by adding Neurons into them.
+ *             The positions of the @Partial_solution inputs and inner Neurons are kept in hash maps,
+ *             so every Neuron input is looked up in constant time, and building a @Partial_solution
+ *             is linear in the number of Neuron inputs inside it.
  */
 class Partial_solution_builder{
 
@@ -22,6 +28,7 @@ public:
   Partial_solution_builder(const SparseNet& net, Partial_solution& partial_ref)
   : net(net), partial(partial_ref), input_synapse(partial_ref.input_data()){
     previous_neuron_input_source = neuron_input_none;
+    map_partial_indices();
   };
 
   /**
@@ -52,17 +59,86 @@ public:
     }
   }
 
+  /**
+   * @brief      Gets the number of bytes the given @Partial_solution takes, based on the capacity of each of its fields,
+   *             without walking through the message like @SpaceUsedLong does; so it can be checked after every added Neuron.
+   *             It's an approximation of @SpaceUsedLong: the repeated numbers are counted by protobuf itself, but the repeated
+   *             messages are counted without the header of their storage and the messages kept for reuse, and a non-empty
+   *             string with its whole capacity even if it fits inside the string object. So it's within @size_tolerance_bytes
+   *             of @SpaceUsedLong, unless a lot of messages are removed from the repeated fields.
+   *
+   * @param[in]  partial  The partial solution
+   *
+   * @return     The approximate size of the @Partial_solution in bytes
+   */
+  static uint64 get_partial_size_bytes(const Partial_solution& partial);
+
+  /**
+   * @brief      The most @get_partial_size_bytes differs from @SpaceUsedLong: the storage headers of the 4 repeated
+   *             message fields, and the capacity of a string short enough to be stored inside the string object
+   */
+  static const uint64 size_tolerance_bytes = 4 * sizeof(void*) + sizeof(std::string);
+
 private:
 
+  /**
+   * @brief      Gets the bytes a repeated field of numbers allocates besides itself
+   */
+  template<typename T>
+  static uint64 repeated_field_bytes(const google::protobuf::RepeatedField<T>& field){
+    return field.SpaceUsedExcludingSelfLong();
+  }
+
+  /**
+   * @brief      Gets the bytes a repeated message field allocates besides itself: its capacity of pointers and the messages in it
+   */
+  template<typename T>
+  static uint64 repeated_field_bytes(const RepeatedPtrField<T>& field){
+    return field.Capacity() * sizeof(T*) + field.size() * sizeof(T);
+  }
+
+  /**
+   * @brief      Gets the bytes a string field allocates besides the message: the string and its capacity, unless it's empty
+   */
+  static uint64 string_bytes(const std::string& field){
+    return (field.empty())?(0):(sizeof(std::string) + field.capacity());
+  }
+
+  /**
+   * @brief      Fills the positions of the inputs, inner Neurons and copied weight intervals already inside the @Partial_solution
+   */
+  void map_partial_indices(void);
+
+  /**
+   * @brief      Registers an interval of the @Partial_solution weight table in @copied_weight_synapses,
+   *             if it was copied from a single interval of the net weight table, based on the weight sources
+   *
+   * @param[in]  partial_start  The start of the interval inside the @Partial_solution weight table
+   * @param[in]  interval_size  The number of weights in the interval
+   */
+  void map_weight_synapse(uint32 partial_start, uint32 interval_size);
+
+  /**
+   * @brief      Gets the key of a Neuron input inside @partial_input_positions
+   *
+   * @param[in]  neuron_input_index  The neuron input index
+   * @param[in]  delayed             Whether the input reads the data of the Neuron from the previous run
+   */
+  static uint64 get_input_key(int neuron_input_index, bool delayed){
+    return (static_cast<uint64>(static_cast<uint32>(neuron_input_index)) << 1) | static_cast<uint64>(delayed);
+  }
+
   /**
    * @brief      Looks for the given Neuron index in the @Partial_solution input,
    *             and adds the input to it if found
    *
    * @param[in]  neuron_input_index  The neuron input index to look for
+   * @param[in]  delayed             Whether the input reads the data of the Neuron from the previous run;
+   *                                 only matched by the @Partial_solution inputs of the same kind
    *
    * @return     returns true if the neuron index was found in the @Partial_solution input
    */
-  bool look_for_neuron_input(int neuron_input_index);
+  bool look_for_neuron_input(int neuron_input_index, bool delayed);
 
   /**
    * @brief      Looks for the given Neuron index in the @Partial_solution internally,
@@ -74,12 +150,27 @@ private:
    */
   bool look_for_neuron_input_internally(uint32 neuron_input_index);
 
+  /**
+   * @brief      Copies the given interval of the net weight table into the @Partial_solution weight table,
+   *             unless the same interval is already copied in for a previous Neuron; Weight-tied and
+   *             convolution-like Neurons share their weights, so the shared weights are stored only once.
+   *
+   * @param[in]  weight_synapse  The interval of the weights inside the net weight table
+   *
+   * @return     The start of the interval inside the @Partial_solution weight table
+   */
+  uint32 copy_weight_synapse(const Synapse_interval& weight_synapse);
+
   /**
    * Global references to help build the solution
    */
   reference_wrapper<const SparseNet> net;
   reference_wrapper<Partial_solution> partial;
   Synapse_iterator input_synapse;
+  std::unordered_map<uint64, uint32> copied_weight_synapses; /* {net weight start, size} --> start inside the @Partial_solution weight table */
+  std::unordered_map<uint64, uint32> partial_input_positions; /* {neuron input index, delayed} --> position inside the @Partial_solution input */
+  std::unordered_map<uint32, uint32> inner_neuron_positions; /* neuron index --> position inside the @Partial_solution Inner Neurons */
+  uint32 partial_input_size = 0; /* The number of inputs of the @Partial_solution */
 
   /**
    * Temporary helper variables used only during Neuron mapping which is started by @add_neuron_to_partial_solution
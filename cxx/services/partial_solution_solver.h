@@ -2,34 +2,125 @@
 #define Partial_solution_H
 
 #include <vector>
+#include <algorithm>
 
 #include "sparse_net_global.h"
 
 #include "gen/sparse_net.pb.h"
 #include "gen/solution.pb.h"
 #include "services/synapse_iterator.h"
+#include "services/packed_synapses.h"
 
 namespace sparse_net_library {
 
 using std::vector;
 using std::reference_wrapper;
+using google::protobuf::RepeatedField;
 
+/**
+ * @brief      Solves a @Partial_solution. The structure of the given @Partial_solution is verified
+ *             once in the constructor, which throws in case it is invalid. Solving a verified @Partial_solution
+ *             runs without any further bounds checks, unless the solver is constructed in checked mode,
+ *             which verifies every access while solving, for debugging purposes.
+ */
 class Partial_solution_solver{
 
 public:
-  Partial_solution_solver(const Partial_solution& partial_solution)
-  : detail(partial_solution), internal_iterator(detail.get().inside_indices()),input_iterator(partial_solution.input_data())
+  Partial_solution_solver(const Partial_solution& partial_solution, bool checked_ = false)
+  : detail(partial_solution), inside_indices(&partial_solution.inside_indices())
+  , index_synapse_numbers(partial_solution.index_synapse_number())
+  , input_iterator(partial_solution.input_data()), checked(checked_)
   {
+    for(const Synapse_interval& input_synapse : partial_solution.input_data())
+      input_size += input_synapse.interval_size();
+    if(!is_valid()) throw "Invalid Partial solution!";
+    scan_neuron_ranges();
     reset();
   }
 
   /**
-   * @brief      Gets the size of the elements taken by the configurad Patial solution.
+   * @brief      Constructs a solver which doesn't collect its own inputs, but reads them from a buffer shared with
+   *             other @Partial_solution elements, e.g. the row input gathered by the @Solution_solver. The Neurons
+   *             take their inputs based on the given synapses instead of the inside indices of the @Partial_solution,
+   *             where negative indices point into the shared buffer. The input synapses are packed by the solver, so they
+   *             only need to live while it is constructed; the synapse numbers shall live as long as the solver does.
+   *
+   * @param[in]  partial_solution       The partial solution
+   * @param[in]  shared_inside_indices  The input synapses of the Neurons
+   * @param[in]  index_synapse_numbers_ The number of synapses each Neuron has in @shared_inside_indices
+   * @param[in]  shared_input_size      The size of the shared input buffer
+   * @param[in]  checked_               Whether to verify every access while solving
+   */
+  Partial_solution_solver(
+    const Partial_solution& partial_solution, const RepeatedPtrField<Synapse_interval>& shared_inside_indices,
+    const RepeatedField<uint32>& index_synapse_numbers_, uint32 shared_input_size, bool checked_ = false
+  ): detail(partial_solution), inside_indices(&shared_inside_indices), index_synapse_numbers(index_synapse_numbers_)
+  , input_iterator(partial_solution.input_data()), input_size(shared_input_size), shared_input(true), checked(checked_)
+  {
+    if(!is_valid()) throw "Invalid Partial solution!";
+    scan_neuron_ranges();
+    reset();
+    inside_indices = nullptr; /* Only read through @packed_inside_indices from now on */
+  }
+
+  /**
+   * @brief      Gets the size of the elements taken by the configurad Patial solution,
+   *             or the size of the shared input buffer in case the inputs are shared.
    *
    * @return     The input size in number of elements ( @sdouble32 ).
    */
-  uint32 get_input_size(void) const;
-  void collect_input_data(vector<sdouble32>& input_data, vector<sdouble32> neuron_data);
+  uint32 get_input_size(void) const{
+    return input_size;
+  }
+
+  /**
+   * @brief      Gets the number of Neurons calculated by the @Partial_solution
+   *
+   * @return     The number of internal Neurons
+   */
+  uint32 get_internal_neuron_number(void) const{
+    return detail.get().internal_neuron_number();
+  }
+
+  /**
+   * @brief      Gets the number of network inputs the @Partial_solution reads from
+   *
+   * @return     The index of the biggest network input index taken by the @Partial_solution + 1
+   */
+  uint32 get_required_input_size(void) const;
+
+  /**
+   * @brief      Sets the preprocessing of the network inputs, applied while the inputs are collected by
+   *             @collect_input_data and @collect_batch_input_data, so the inputs don't need a separate pass.
+   *             Throws in case any transformation is invalid, or there's none for a network input
+   *             the @Partial_solution reads. The given transformations shall live as long as the solver does;
+   *             an empty array disables the preprocessing.
+   *
+   * @param[in]  transforms  The transformation of every network input
+   */
+  void set_input_transforms(const RepeatedPtrField<Input_transform>& transforms);
+
+  /**
+   * @brief      Collects the input of the partial solution from the given network input
+   *             and Neuron data. The sizes of the given arrays are only checked in checked mode,
+   *             otherwise they shall be able to provide every input of the @Partial_solution.
+   *
+   * @param      input_data   The input data of the network
+   * @param[in]  neuron_data  The data of the Neurons
+   */
+  void collect_input_data(const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data);
+
+  /**
+   * @brief      Same as @collect_input_data, but the inputs are collected into the given buffer
+   *             instead of the one inside the solver, so the solver itself is not modified.
+   *
+   * @param[in]  input_data       The input data of the network
+   * @param[in]  neuron_data      The data of the Neurons
+   * @param      collected_input  The buffer to collect the inputs into, of at least @get_input_size elements
+   */
+  void collect_input_data(
+    const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data, vector<sdouble32>& collected_input
+  ) const;
 
   /**
    * @brief      Solves the detail given in the argument, then cleans it up and returns the solution
@@ -39,25 +130,287 @@ public:
   vector<sdouble32> solve();
 
   /**
-   * @brief      Resets the data of the included Neurons.
+   * @brief      Solves the detail based on the given collected inputs, and writes the data of the
+   *             internal Neurons into the given buffer. Only the data of the Neurons with memory
+   *             is kept inside the solver between runs.
+   *
+   * @param[in]  collected_input  The inputs collected by @collect_input_data
+   * @param      neuron_output    The buffer for the result, of at least @internal_neuron_number elements
+   */
+  void solve(const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output);
+
+  /**
+   * @brief      Gets the Neurons from which on no Neuron takes its input from any Neuron before them inside the
+   *             @Partial_solution, in ascending order. A range of Neurons starting at one of them can be solved
+   *             in parallel with the Neurons before it, so the Neurons can be divided at these into independent ranges.
+   *
+   * @return     The independent Neurons; the first Neuron is not included
+   */
+  const vector<uint32>& get_independent_neurons(void) const{
+    return independent_neurons;
+  }
+
+  /**
+   * @brief      Gets the Neurons at which a new wavefront starts, in ascending order. The Neurons are divided into
+   *             continuous wavefronts, so no Neuron takes its input from a Neuron of its own wavefront; once every
+   *             wavefront before it is solved, the Neurons of a wavefront can be solved in any number of ranges in parallel.
+   *             Partials built from layers of Neurons have a wavefront for every layer.
+   *
+   * @return     The first Neuron of every wavefront; the first Neuron is not included
+   */
+  const vector<uint32>& get_wavefronts(void) const{
+    return wavefronts;
+  }
+
+  /**
+   * @brief      Gets the number of consecutive Neurons from the given one on, which take exactly the same inputs
+   *             and differ only in their weights. Such Neurons are solved in blocks of @max_neuron_block or fewer
+   *             Neurons, so every input is read once for the whole block instead of once for every Neuron.
+   *
+   * @param[in]  neuron_index  The index of the Neuron inside the @Partial_solution
+   *
+   * @return     The number of Neurons with the same inputs, including the given one
+   */
+  uint32 get_same_input_neurons(uint32 neuron_index) const{
+    return same_input_neurons[neuron_index];
+  }
+
+  static const uint32 max_neuron_block = 8;
+
+  /**
+   * @brief      Same as @solve, but only solves the Neurons in the given range, which shall start at an
+   *             independent Neuron (see @get_independent_neurons); so the ranges of a @Partial_solution
+   *             can be solved in parallel. In case the wavefronts before the range are already solved,
+   *             the range can also start at a wavefront, or lie inside one (see @get_wavefronts).
+   *             The data of the Neurons is written to their place in the given buffer, the other elements of it are not modified.
+   *
+   * @param[in]  collected_input             The inputs collected by @collect_input_data
+   * @param      neuron_output               The buffer for the result, of at least @internal_neuron_number elements
+   * @param[in]  first_neuron                The first Neuron to solve
+   * @param[in]  end_neuron                  The Neuron after the last one to solve
+   * @param[in]  previous_wavefronts_solved  Whether the wavefronts before the one of @first_neuron are already solved
+   */
+  void solve(
+    const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 first_neuron, uint32 end_neuron,
+    bool previous_wavefronts_solved = false
+  );
+
+  /**
+   * @brief      Collects the input of the partial solution for a batch of independent samples. Every element
+   *             of the given arrays is stored as @batch_size consecutive lanes, one for each sample:
+   *             the element under index i of sample l is under [i * batch_size + l]. The collected inputs
+   *             follow the same layout.
+   *
+   * @param[in]  input_data       The input data of the network for every sample
+   * @param[in]  neuron_data      The data of the Neurons for every sample
+   * @param      collected_input  The buffer to collect the inputs into, of at least @get_input_size * @batch_size elements
+   * @param[in]  batch_size       The number of samples
+   */
+  void collect_batch_input_data(
+    const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data,
+    vector<sdouble32>& collected_input, uint32 batch_size
+  ) const;
+
+  /**
+   * @brief      Solves the detail for a batch of independent samples, based on the inputs collected
+   *             by @collect_batch_input_data; the result has the same layout as the inputs. Every weight
+   *             is applied to all of the lanes of an input at once, so the samples are processed together
+   *             even if the inputs of the Neurons are fragmented. Every lane has its own Neuron memory,
+   *             separate from the memory used by @solve; it is reset when the size of the batch changes.
+   *
+   * @param[in]  collected_input  The inputs collected by @collect_batch_input_data
+   * @param      neuron_output    The buffer for the result, of at least @internal_neuron_number * @batch_size elements
+   * @param[in]  batch_size       The number of samples
+   */
+  void solve_batch(const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 batch_size);
+
+  /**
+   * @brief      Same as @solve_batch, but only solves the Neurons in the given range, like the range version of @solve.
+   *             Before solving ranges in parallel, the Neuron memory of the lanes shall be prepared by @prepare_batch.
+   */
+  void solve_batch(
+    const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 batch_size,
+    uint32 first_neuron, uint32 end_neuron, bool previous_wavefronts_solved = false
+  );
+
+  /**
+   * @brief      Prepares the Neuron memory of the lanes for a batch of the given size: in case the size
+   *             of the batch changes, the memory of the lanes is reset.
+   */
+  void prepare_batch(uint32 batch_size);
+
+  /**
+   * @brief      Resets the data of the included Neurons. The structure of the @Partial_solution
+   *             is not scanned again, only the memory of the Neurons is cleared, and the Neurons are
+   *             classified again as stateful or stateless based on @neuron_memoryless. Stateless Neurons
+   *             don't read their memory filter, or keep their previous value while solving.
    */
   void reset(void);
 
   /**
-   * @brief      Determines if given Solution Detail is valid. Due to performance reasons
-   *             this function isn't used while solving a SparseNet
+   * @brief      Classifies the Neurons again as stateful or stateless based on @neuron_memoryless, e.g. after
+   *             the memory filters of the @Partial_solution are updated; without resetting the memory of the
+   *             Neurons which stay stateful. Neurons becoming stateful start from an empty memory.
+   */
+  void refresh_neurons(void);
+
+  /**
+   * @brief      Reads the weights while solving from the given copy of the weight table of the @Partial_solution,
+   *             stored in its format, instead of the @Partial_solution itself; e.g. a copy on the NUMA node of
+   *             the workers solving it. The copy shall live as long as the solver does; nullptr reads the
+   *             weights of the @Partial_solution again.
    *
-   * @return     True if detail is vmakealid, False otherwise.
+   * @param[in]  weight_data_  The copy of @weight_table or @half_weight_table
    */
-  bool is_valid(void);
+  void set_weight_data(const void* weight_data_){
+    weight_data = weight_data_;
+  }
+
+  /**
+   * @brief      Exchanges the memory of the Neurons with memory, used by @solve, with the given buffer;
+   *             so the solver of a @Partial_solution can be dropped and constructed again without losing
+   *             the previous data of its Neurons. Throws in case the size of the buffer doesn't match.
+   *
+   * @param      memory  The memory to exchange, of the number of Neurons with memory
+   */
+  void swap_neuron_memory(vector<sdouble32>& memory){
+    if(memory.size() != neuron_memory.size()) throw "Neuron memory of a different size!";
+    neuron_memory.swap(memory);
+  }
+
+  /**
+   * @brief      Gets the number of Neurons with memory, which is the size of the buffer @swap_neuron_memory takes
+   */
+  uint32 get_neuron_memory_size(void) const{
+    return neuron_memory.size();
+  }
+
+  /**
+   * @brief      Determines if given Solution Detail is valid: every input, weight, bias and memory filter
+   *             index is in bounds, every Neuron takes only Neurons before itself as input and the number of
+   *             inputs match the number of weights for every Neuron. Delayed inputs are only valid when the inputs are
+   *             shared, as only the @Solution_solver keeps the data of the previous run. Due to performance reasons
+   *             this function is only used while constructing the solver. As the shared input synapses are not kept
+   *             after the construction, a solver with shared inputs is only verified while it is constructed.
+   *
+   * @return     True if detail is valid, False otherwise.
+   */
+  bool is_valid(void) const;
 
 private:
   reference_wrapper<const Partial_solution> detail;
-  Synapse_iterator internal_iterator;
+  const RepeatedPtrField<Synapse_interval>* inside_indices; /* The input synapses of the Neurons; nullptr after construction with shared inputs */
+  reference_wrapper<const RepeatedField<uint32>> index_synapse_numbers;
   Synapse_iterator input_iterator;
-  vector<sdouble32> neuron_output;
+  Packed_synapses packed_inside_indices; /* The inputs of the Neurons, read by the solving kernels */
+  Packed_synapses packed_input_data; /* The inputs of the @Partial_solution, read while collecting them */
+  vector<sdouble32> neuron_memory; /* The previous data of the Neurons with memory */
+  vector<sdouble32> batch_neuron_memory; /* The previous data of the Neurons with memory in every lane of the batches */
+  uint32 batch_size_in_memory = 0;
+  uint32 number_of_neurons_with_memory = 0;
+  struct Neuron_start{ /* Where the data of a Neuron starts, so solving can start at any Neuron */
+    uint32 index_synapse;
+    uint32 packed_index_synapse; /* The offset of the inputs of the Neuron in @packed_inside_indices */
+    uint32 weight_synapse;
+    uint32 memory_index;
+  };
+  vector<Neuron_start> neuron_starts;
+  vector<uint8> stateful_neurons; /* Whether each Neuron depends on its previous value; read instead of the @Partial_solution while solving */
+  vector<uint32> independent_neurons;
+  vector<uint32> wavefronts; /* The first Neuron of every wavefront after the first one */
+  vector<uint32> same_input_neurons; /* The number of Neurons from each Neuron on with the same inputs */
+  vector<sdouble32> neuron_output; /* Buffers for the solver's own inputs and outputs */
   vector<sdouble32> collected_input_data;
+  const RepeatedPtrField<Input_transform>* input_transforms = nullptr; /* The preprocessing of the network inputs, if any */
+  const void* weight_data = nullptr; /* The weights read while solving, if not the ones in the @Partial_solution */
+  uint32 input_size = 0;
+  bool shared_input = false;
+  bool checked = false;
 
+  /**
+   * @brief      Determines if the data of the given Neuron depends on its previous value
+   */
+  bool has_memory(uint32 neuron_index) const{
+    return ((0 == detail.get().neuron_memoryless_size())||(!detail.get().neuron_memoryless(neuron_index)));
+  }
+
+  /**
+   * @brief      Classifies every Neuron as stateful or stateless, and places the stateful ones in the Neuron memory
+   */
+  void classify_neurons(void);
+
+  /**
+   * @brief      Scans where the synapses of every Neuron start, which Neurons are independent
+   *             from the ones before them, and where the wavefronts start, based on the structure of the @Partial_solution;
+   *             and packs the input synapses for the solving kernels
+   */
+  void scan_neuron_ranges(void);
+
+  /**
+   * @brief      Gets the first weight synapse of the given Neuron, or nullptr in case it has none
+   */
+  const Synapse_interval* first_weight_synapse(uint32 neuron_index) const{
+    if(0 == detail.get().weight_synapse_number(neuron_index)) return nullptr;
+    return &detail.get().weight_indices(neuron_starts[neuron_index].weight_synapse);
+  }
+
+  /**
+   * @brief      Gets the weight synapse under the given index, or the given one in case the index is past the last synapse
+   */
+  const Synapse_interval* next_weight_synapse(uint32 weight_synapse_index, const Synapse_interval* weight_synapse) const{
+    if(static_cast<int>(weight_synapse_index) < detail.get().weight_indices_size())
+      return &detail.get().weight_indices(weight_synapse_index);
+    return weight_synapse;
+  }
+
+  /**
+   * @brief      Gets the number of Neurons to solve together from the given one on, before the end of the range
+   */
+  uint32 get_neuron_block(uint32 neuron_index, uint32 end_neuron) const{
+    const uint32 neurons = std::min(same_input_neurons[neuron_index], end_neuron - neuron_index);
+    if(max_neuron_block <= neurons) return max_neuron_block;
+      else if((max_neuron_block / 2) <= neurons) return (max_neuron_block / 2);
+      else return 1;
+  }
+
+  /**
+   * @brief      Verifies if the given range of Neurons can be solved by itself, or after the wavefronts before it
+   */
+  bool is_neuron_range_valid(uint32 first_neuron, uint32 end_neuron, bool previous_wavefronts_solved) const;
+
+  /**
+   * @brief      The implementation of @collect_input_data and @solve, with or without
+   *             checking every access to the underlying data, or preprocessing the inputs; the weights are read through the
+   *             given reader of the @weight_storage of the @Partial_solution
+   */
+  template<bool checked_access, bool transformed> void collect_input_data_internal(
+    const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data, vector<sdouble32>& collected_input
+  ) const;
+  template<bool checked_access, typename Weight_table> void solve_internal(
+    const Weight_table& weights, const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 first_neuron, uint32 end_neuron
+  );
+  template<bool checked_access, bool transformed> void collect_batch_input_data_internal(
+    const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data,
+    vector<sdouble32>& collected_input, uint32 batch_size
+  ) const;
+  template<bool checked_access, typename Weight_table> void solve_batch_internal(
+    const Weight_table& weights, const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 batch_size,
+    uint32 first_neuron, uint32 end_neuron
+  );
+
+  /**
+   * @brief      Sums the weighted inputs of the given number of Neurons with the same inputs, starting from @first_neuron;
+   *             every input is read once, and multiplied by the weight of every Neuron of the block.
+   *             The lane version writes the sums of every lane into the place of the Neurons in @neuron_output.
+   */
+  template<bool checked_access, uint32 block_size, typename Weight_table> void sum_neuron_inputs(
+    const Weight_table& weights, const vector<sdouble32>& collected_input, const vector<sdouble32>& neuron_output,
+    uint32 first_neuron, sdouble32* neuron_data
+  ) const;
+  template<bool checked_access, uint32 block_size, typename Weight_table> void sum_neuron_input_lanes(
+    const Weight_table& weights, const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output, uint32 batch_size,
+    uint32 first_neuron
+  ) const;
 };
 
 } /* namespace sparse_net_library */
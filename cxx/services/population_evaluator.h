@@ -0,0 +1,145 @@
+#ifndef POPULATION_EVALUATOR_H
+#define POPULATION_EVALUATOR_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <memory>
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+#include "models/service_context.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/worker_pool.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+using std::unique_ptr;
+
+/**
+ * @brief      Evaluates a population of @SparseNet candidates on the same data, e.g. for architecture search.
+ *             The @Solution of every candidate is built by the workers in parallel, and every candidate is solved
+ *             on the same @Worker_pool, so the candidates don't start threads of their own. The samples are packed
+ *             into batches once, and every batch is submitted to every candidate right after each other, so the
+ *             candidates read the same batch while it is still in cache; the tasks of the candidates are interleaved
+ *             on the workers, which steal them from each other. Only a few batches are in flight at once,
+ *             so the memory needed doesn't depend on the number of samples. In a search loop, the candidates can be raced
+ *             against the best error so far, stopping the ones which can't beat it before every sample is solved.
+ *             The referenced nets shall live as long as the evaluator does.
+ */
+class Population_evaluator{
+public:
+  /**
+   * @brief      The result of evaluating every candidate on a set of samples
+   */
+  struct Evaluation{
+    vector<sdouble32> errors; /* The error of every candidate on the samples it is evaluated with, by the cost function of its @SparseNet */
+    vector<uint32> evaluated_samples; /* The number of samples every candidate is evaluated with before it is stopped */
+    sdouble32 seconds; /* The time it took to solve the candidates with the samples */
+    sdouble32 candidate_samples_per_second; /* The number of samples solved by the candidates in a second, counted for each candidate */
+  };
+
+  /**
+   * @brief      Builds the @Solution of every candidate in parallel, and constructs their solvers
+   *
+   * @param[in]  nets_             The candidates to evaluate
+   * @param[in]  solution_builder  The builder configured to build the @Solution of every candidate;
+   *                               the Solutions are owned by the evaluator, so its arena is not used
+   * @param[in]  context           The context of the workers shared by the candidates
+   */
+  Population_evaluator(
+    const vector<const SparseNet*>& nets_, Solution_builder solution_builder = Solution_builder(),
+    Service_context context = Service_context()
+  );
+
+  /**
+   * @brief      Solves every candidate with every sample, and calculates its error compared to the labels.
+   *             The samples are solved in batches of independent samples, so the samples of every batch continue
+   *             the Neuron memory of the sample under the same lane in the previous batch of the same size,
+   *             the same way as in @Solution_solver::solve_batch.
+   *
+   * @param[in]  input_samples  The network input of every sample
+   * @param[in]  label_samples  The expected output of every sample
+   * @param[in]  batch_size     The number of samples in a batch; the last batch might be smaller
+   *
+   * @return     The error of every candidate, and the throughput of the evaluation
+   */
+  Evaluation evaluate(
+    const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size
+  );
+
+  /**
+   * @brief      Evaluates the candidates the same way as @evaluate, but stops every candidate as soon as its error on the
+   *             samples solved so far shows it can't have an error below the given bound on every sample; the samples
+   *             of a stopped candidate are not solved any further. The error on the rest of the samples is estimated
+   *             from the mean and the variance of the cost of the solved samples, so a candidate is stopped when the
+   *             estimated error is above the bound with the given confidence. The candidate is checked after every batch,
+   *             so the probability of a wrong stop is divided between the batches, to hold the confidence over every check.
+   *             With a confidence of 1, a candidate is only stopped when its error is surely above the bound, because the
+   *             cost of the samples so far is already above it. The batches already submitted to a candidate when it is
+   *             stopped (a few batches ahead) are still solved and continue its Neuron memory, but they are not counted
+   *             in its error.
+   *
+   * @param[in]  input_samples  The network input of every sample
+   * @param[in]  label_samples  The expected output of every sample
+   * @param[in]  batch_size     The number of samples in a batch; candidates are only stopped between batches
+   * @param[in]  cost_bound     The error to beat, e.g. the error of the best candidate so far
+   * @param[in]  confidence     The probability of every stopped candidate not being able to beat the bound, in [0.5,1]
+   *
+   * @return     The error of every candidate on the samples it is evaluated with, and the throughput of the evaluation
+   */
+  Evaluation race(
+    const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size,
+    sdouble32 cost_bound, sdouble32 confidence = 0.99
+  );
+
+  /**
+   * @brief      Gets the lowest error a candidate is expected to have on every sample, based on the samples evaluated so far:
+   *             the rest of the samples are expected to cost at least the lower confidence bound of the mean cost of a sample.
+   *
+   * @param[in]  cost_sum           The sum of the cost of the evaluated samples
+   * @param[in]  cost_square_sum    The sum of the squared cost of the evaluated samples
+   * @param[in]  evaluated_samples  The number of evaluated samples
+   * @param[in]  number_of_samples  The number of every sample
+   * @param[in]  deviations         The number of standard deviations the lower confidence bound is below the mean
+   *
+   * @return     The lowest expected error on every sample
+   */
+  static sdouble32 get_lowest_expected_error(
+    sdouble32 cost_sum, sdouble32 cost_square_sum, uint32 evaluated_samples, uint32 number_of_samples, sdouble32 deviations
+  );
+
+  /**
+   * @brief      Gets the number of candidates in the population
+   */
+  uint32 get_number_of_candidates(void) const{
+    return solutions.size();
+  }
+
+  /**
+   * @brief      Gets the @Solution built for the given candidate
+   */
+  const Solution& get_solution(uint32 candidate_index) const{
+    return *solutions[candidate_index];
+  }
+
+private:
+  /**
+   * @brief      Solves the candidates with the samples, stopping the ones whose error is above the bound with the given confidence
+   */
+  Evaluation solve_samples(
+    const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size,
+    sdouble32 cost_bound, sdouble32 confidence
+  );
+
+  const vector<const SparseNet*> nets;
+  vector<unique_ptr<Solution>> solutions;
+  unique_ptr<Worker_pool> workers; /* Shall be destroyed after the solvers using it */
+  vector<unique_ptr<Solution_solver>> solvers;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* POPULATION_EVALUATOR_H */
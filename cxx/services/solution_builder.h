@@ -53,6 +53,20 @@ public:
     return *this;
   }
 
+  /**
+   * @brief      Sets the format the weights of the built @Partial_solution elements are stored in.
+   *             The 16 bit formats halve the memory and bandwidth of the weights compared to 32 bit floats,
+   *             and quarter it compared to double; they are widened while solving.
+   *
+   * @param[in]  storage  The format of the weights
+   *
+   * @return     Builder reference for chaining
+   */
+  Solution_builder& weight_storage(weight_storages storage){
+    arg_weight_storage = storage;
+    return *this;
+  }
+
   /**
    * @brief      Set the used arena pointer
    *
@@ -95,6 +109,7 @@ private:
   google::protobuf::Arena* arg_arena_ptr = nullptr;
   uint8 arg_max_solve_threads = 1;
   sdouble32 arg_device_max_megabytes = 2.0 /* GB */ * 1024.0/* MB */;
+  weight_storages arg_weight_storage = WEIGHT_STORAGE_DOUBLE;
 };
 
 } /* namespace sparse_net_library */
@@ -5,22 +5,47 @@
 
 #include <vector>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <exception>
+#include <limits>
 
 #include "gen/solution.pb.h"
 #include "models/service_context.h"
+#include "models/ring_buffer.h"
+#include "models/huge_page_storage.h"
 #include "services/partial_solution_solver.h"
+#include "services/memory_planner.h"
+#include "services/worker_pool.h"
 
 namespace sparse_net_library{
 
 using std::vector;
+using std::unique_ptr;
+using std::shared_ptr;
+using std::future;
+using std::promise;
 
 /**
  * @brief      This class Processes a @Solution given in its constructor and handles
  *             the distribution of the needed resources for it.
+ *             Every @Partial_solution is solved by a pool of worker threads, row by row: the inputs of a row
+ *             are gathered once, then its @Partial_solution elements are solved in parallel. Consecutive inputs
+ *             are solved in a pipeline, but always in the order of their submission, since Neurons have memory.
  */
 class Solution_solver{
 public:
+  /**
+   * @brief      Verifies the structure of the given @Solution, and throws if it is invalid; so solving it runs
+   *             without any bounds checks, unless checked mode is set in the @Service_context.
+   *             Multiple solvers can share one @Worker_pool through the @Service_context,
+   *             so their tasks are interleaved on the same threads.
+   */
   Solution_solver(const Solution& to_solve, Service_context context = Service_context());
+  Solution_solver(Solution_solver&& other);
+  ~Solution_solver();
 
   /**
    * @brief      Solves the Solution given in the constructor, considering the previous runs
@@ -31,31 +56,330 @@ public:
    */
   vector<sdouble32> solve(vector<sdouble32> input);
 
-private:
+  /**
+   * @brief      Same as @solve, but the result is written into the given buffer. Once the solver
+   *             is warmed up and the buffer has the size of the output, solving doesn't allocate any memory.
+   *
+   * @param[in]  input   The input data to be taken
+   * @param      output  The buffer for the resulting output of the SparseNet
+   */
+  void solve(const vector<sdouble32>& input, vector<sdouble32>& output);
+
+  /**
+   * @brief      Queues the given input to be solved by the workers of the solver without blocking the caller.
+   *             The inputs are solved in the order of submission, considering the previous runs.
+   *             The @Partial_solution elements of a later input are started as soon as the same @Partial_solution
+   *             is finished with the previous input, and the row before it is finished with the later input.
+   *
+   * @param[in]  input  The input data to be taken
+   *
+   * @return     The resulting output of the SparseNet, available once every row is solved with the input
+   */
+  future<vector<sdouble32>> submit(vector<sdouble32> input);
+
+  /**
+   * @brief      Solves a batch of independent samples in one pass. The batch dimension is innermost:
+   *             the input under index i of sample l is under [i * batch_size + l], and the outputs follow
+   *             the same layout. Every sample of the batch is a separate sequence with its own Neuron memory,
+   *             continued by the next batch of the same size, and kept apart from the memory of @solve.
+   *
+   * @param[in]  inputs      The input data of every sample
+   * @param[in]  batch_size  The number of samples
+   *
+   * @return     The resulting outputs of the SparseNet for every sample.
+   */
+  vector<sdouble32> solve_batch(vector<sdouble32> inputs, uint32 batch_size);
+
+  /**
+   * @brief      Same as @solve_batch, but the result is written into the given buffer,
+   *             without allocating any memory once the solver is warmed up with the same batch size.
+   *
+   * @param[in]  inputs      The input data of every sample
+   * @param[in]  batch_size  The number of samples
+   * @param      outputs     The buffer for the resulting outputs of the SparseNet for every sample
+   */
+  void solve_batch(const vector<sdouble32>& inputs, uint32 batch_size, vector<sdouble32>& outputs);
+
+  /**
+   * @brief      Queues a batch of independent samples to be solved, the same way as @submit does with a single input.
+   *             The layout of the data is the same as in @solve_batch.
+   *
+   * @param[in]  inputs      The input data of every sample
+   * @param[in]  batch_size  The number of samples
+   *
+   * @return     The resulting outputs of the SparseNet for every sample, available once every row is solved with them
+   */
+  future<vector<sdouble32>> submit_batch(vector<sdouble32> inputs, uint32 batch_size);
+
+  /**
+   * @brief      Same as @submit_batch, but the inputs are not copied: the job only keeps a reference to them
+   *             until it is finished, so the same batch can be submitted to multiple solvers.
+   *
+   * @param[in]  inputs      The input data of every sample, not to be changed until every job using it is finished
+   * @param[in]  batch_size  The number of samples
+   *
+   * @return     The resulting outputs of the SparseNet for every sample, available once every row is solved with them
+   */
+  future<vector<sdouble32>> submit_batch(shared_ptr<const vector<sdouble32>> inputs, uint32 batch_size);
+
+  /**
+   * @brief      Classifies the Neurons of every @Partial_solution again as stateful or stateless, after their
+   *             memory filters are updated in place, e.g. by a @Weight_updater. The memory of the Neurons staying
+   *             stateful is kept. Updated weights are read by the solver without this, unless they are copied onto
+   *             the NUMA nodes, see @refresh_weights.
+   *             Shall not be called while any input is being solved.
+   */
+  void refresh_neurons(void);
+
+  /**
+   * @brief      Copies the weights of every @Partial_solution again onto the NUMA node of the workers solving it,
+   *             after they are updated in place, e.g. by a @Weight_updater. Only needed with workers on more than
+   *             one node, as otherwise the weights are read from the @Solution directly.
+   *             Shall not be called while any input is being solved.
+   */
+  void refresh_weights(void);
 
   /**
-   * @brief      Gets a @Partial_Solution reference from the solution based on the given coordinates.
+   * @brief      Determines if the given @Solution is valid: every row has columns, every Neuron is calculated
+   *             by exactly one @Partial_solution, and every @Partial_solution takes Neuron data as input only from
+   *             the previous rows, or from any calculated Neuron through delayed inputs. The @Partial_solution
+   *             elements are verified by their solvers.
    *
-   * @param[in]  row       The row
-   * @param[in]  col       The col
-   * @param[in]  solution  The solution
+   * @return     True if the solution is valid, False otherwise.
+   */
+  bool is_valid(void) const;
+
+  /**
+   * @brief      Gets the kind of pages the Neuron data of the latest solved input is stored in.
+   *             Only huge pages are used, in case it is set in the @Service_context, and the Neuron data
+   *             is at least the size of a huge page. Shall not be called while any input is being solved.
    *
-   * @return     The @Partial_solution reference.
+   * @return     The backing pages of the Neuron data.
    */
-  static const Partial_solution& get_partial(uint32 row, uint32 col, const Solution& solution){
-    if(solution.cols_size() <= static_cast<int>(row)) throw "Row index out of bounds!";
-    uint32 index = 0;
-    for(uint32 i = 0;i < row; ++i) index += solution.cols(i);
-    return solution.partial_solutions(index + col);
+  Page_backing get_neuron_data_backing(void) const{
+    return neuron_data_allocator.get_backing();
   }
 
-  void solve_a_partial(vector<sdouble32>& input, uint32 row_iterator, uint32 col_iterator, uint32 partial_solution_start);
+  /**
+   * @brief      Gets the number of Neuron ranges the @Partial_solution elements are solved in; equals the number
+   *             of @Partial_solution elements unless any of them is divided between the workers.
+   */
+  uint32 get_number_of_neuron_ranges(void) const{
+    return neuron_ranges.size();
+  }
+
+  /**
+   * @brief      Gets the number of stages the @Partial_solution elements are solved in; equals the number
+   *             of @Partial_solution elements unless any of them has multiple wavefronts divided between the workers.
+   */
+  uint32 get_number_of_neuron_stages(void) const{
+    return stage_first_range.size() - 1;
+  }
+
+  /**
+   * @brief      Gets the number of tasks the workers stole from each other so far; in case the
+   *             @Worker_pool is shared, the tasks of every solver using it are counted
+   */
+  uint64 get_number_of_stolen_tasks(void) const{
+    return workers->get_number_of_stolen_tasks();
+  }
+
+private:
+
+  /**
+   * @brief      The data of one submitted input while it is being solved. Finished jobs are kept
+   *             to be reused by later inputs, so their buffers don't need to be allocated again.
+   */
+  struct Solve_job{
+    Solve_job(const Huge_page_allocator<sdouble32>& neuron_data_allocator)
+    : neuron_data(neuron_data_allocator)
+    { }
+
+    uint64 sequence; /* Number of inputs submitted before this one */
+    uint32 batch_size; /* Number of samples in the lanes of a batch, or 0 for a single input */
+    vector<sdouble32> owned_input; /* The input of a submitted job */
+    shared_ptr<const vector<sdouble32>> shared_input; /* The input of a submitted job, shared with other jobs */
+    const vector<sdouble32>* input; /* Either @owned_input, @shared_input, or the input of a caller waiting for the job */
+    vector<sdouble32>* output; /* The output buffer of a caller waiting for the job, or nullptr when it is submitted */
+    vector<sdouble32, Huge_page_allocator<sdouble32>> neuron_data; /* The internal Data of the Neurons, in the slots planned by @memory_plan */
+    const sdouble32* placed_neuron_data = nullptr; /* The Neuron data already placed onto the nodes of the @Numa_topology */
+    vector<sdouble32> row_input; /* The inputs of the row currently solving the job, gathered once for all its partials */
+    uint32 gathered_row; /* The row whose inputs are in @row_input, or @row_not_gathered while waiting for the previous job */
+    vector<uint32> unsolved_partials_in_row; /* Number of @Partial_solution elements in each row still to be solved */
+    vector<uint32> unsolved_ranges; /* Number of Neuron ranges still to be solved in the current stage of every queued @Partial_solution */
+    vector<uint32> partial_stages; /* The stage every queued @Partial_solution is solving, as an index in @stage_first_range */
+    vector<vector<sdouble32>> staged_outputs; /* The outputs of the @Partial_solution elements solved in multiple stages, in their slots */
+    std::exception_ptr error;
+    promise<vector<sdouble32>> result; /* Only used when the job is submitted */
+    bool finished;
+  };
+
+  /**
+   * @brief      A range of Neurons inside a @Partial_solution, inside a wavefront or starting at one
+   */
+  struct Neuron_range{
+    uint32 first_neuron;
+    uint32 end_neuron;
+  };
+
+  /**
+   * @brief      A range of a @Partial_solution ready to be solved with a job
+   */
+  struct Partial_task{
+    shared_ptr<Solve_job> job;
+    uint32 row_iterator;
+    uint32 col_iterator;
+    uint32 range_index; /* The index in @neuron_ranges */
+  };
+
+  /**
+   * @brief      Queues a job with the given input for the workers, and waits for its result
+   */
+  void solve_job(const vector<sdouble32>& input, uint32 batch_size, vector<sdouble32>& output);
+
+  /**
+   * @brief      Queues a job with the given input for the workers, without waiting for its result
+   */
+  future<vector<sdouble32>> submit_job(vector<sdouble32> input, shared_ptr<const vector<sdouble32>> shared_input, uint32 batch_size);
+
+  /**
+   * @brief      Gets an idle job, or creates one if there is none, prepared for the given batch size.
+   *             Shall only be called while holding @scheduler_mutex.
+   */
+  shared_ptr<Solve_job> acquire_job(uint32 batch_size);
+
+  /**
+   * @brief      Gathers the inputs of the given row for the job into its row input, storing the error
+   *             in the job in case there is any. The network inputs are preprocessed by the @input_transforms
+   *             of the @Solution while they are gathered. Shall only be called while no @Partial_solution
+   *             is solving the job.
+   */
+  void gather_row_input(Solve_job& job, uint32 row_iterator) const;
+
+  /**
+   * @brief      Copies the data of the output Neurons of a finished job into the given output buffer
+   */
+  void copy_outputs(const Solve_job& job, vector<sdouble32>& output) const;
+
+  /**
+   * @brief      Queues the first row of a prepared job for the workers, unless it needs to wait for the Neuron data of the
+   *             job before it because of delayed inputs; so a @Solution with delayed inputs solves the inputs one after another
+   *             instead of in a pipeline. Shall only be called while holding @scheduler_mutex.
+   */
+  void start_job(shared_ptr<Solve_job> job);
+
+  /**
+   * @brief      Queues the @Partial_solution elements of the first row which are done with every previous job,
+   *             gathering the input of the row first in case of delayed inputs. Shall only be called while holding @scheduler_mutex.
+   */
+  void start_first_row(shared_ptr<Solve_job> job);
+
+  /**
+   * @brief      Keeps the data of the Neurons read by delayed inputs from a finished job, for the job after it.
+   *             Shall only be called while holding @scheduler_mutex.
+   */
+  void store_past_data(const Solve_job& job);
+
+  /**
+   * @brief      Queues the first stage of the @Partial_solution under the given coordinates to be solved
+   *             with the given job by the workers. Shall only be called while holding @scheduler_mutex.
+   */
+  void push_partial(shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator);
+
+  /**
+   * @brief      Queues every Neuron range in the current stage of the @Partial_solution under the given coordinates
+   *             to be solved with the given job by the workers. Shall only be called while holding @scheduler_mutex.
+   */
+  void push_stage(shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator);
+
+  /**
+   * @brief      Takes the @Partial_task queued by @push_stage under the given index, and solves it.
+   *             Counting the task as returned in @queued_tasks is the last access of it to the solver.
+   */
+  void solve_next_partial(uint32 task_index, uint16 worker_index);
+
+  /**
+   * @brief      Divides every @Partial_solution into stages of Neuron ranges: the ranges of a stage are solved by
+   *             the workers in parallel, and the stages one after another. Every wavefront large enough is a stage
+   *             divided between the workers; the small wavefronts between them are solved in one range.
+   *             The ranges can be stolen by idle workers, so @Partial_solution elements of different cost
+   *             in a row don't keep the workers idle.
+   */
+  void divide_into_ranges(void);
+
+  /**
+   * @brief      Divides the @Partial_solution elements of every row between the nodes of the workers, in case there is
+   *             a @Numa_topology in the @Service_context; they are solved by the workers of their node,
+   *             with their weights and outputs placed there.
+   */
+  void assign_nodes(void);
+
+  /**
+   * @brief      Places the outputs of every @Partial_solution in the Neuron data of the job onto its node
+   */
+  void place_neuron_data(const Solve_job& job) const;
+
+  /**
+   * @brief      Solves a range of a @Partial_solution with the data of the given job; after the last range of it
+   *             updates the scheduling state and queues every @Partial_solution which became solvable.
+   */
+  void solve_a_partial(
+    shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator, uint32 range_index, uint16 worker_index
+  );
+
+  /**
+   * @brief      Gets the job of the given sequence number still under solution, if there is any.
+   *             Shall only be called while holding @scheduler_mutex.
+   */
+  shared_ptr<Solve_job> get_job(uint64 sequence) const{
+    if((0 < jobs_in_flight.size())&&(jobs_in_flight.front()->sequence <= sequence)
+      &&(sequence < (jobs_in_flight.front()->sequence + jobs_in_flight.size()))
+    )return jobs_in_flight[sequence - jobs_in_flight.front()->sequence];
+    else return nullptr;
+  }
 
   const Solution& solution;
-  vector<vector<Partial_solution_solver>> partial_solvers;
-  vector<vector<Synapse_iterator>> partial_solver_output_maps;  /* Maps each output of the partial solvers into an index in @neuron_data */
-  vector<sdouble32> neuron_data;  /* The internal Data of each Neuron */
+  unique_ptr<Memory_planner> memory_plan; /* A Neuron only occupies its slot in the Neuron data while a later row still needs it; with multiple workers the slots start at cache lines */
+  vector<uint32> row_first_partial; /* The index of the first @Partial_solution in every row, and the number of partials at the end */
+  vector<Partial_solution_solver> partial_solvers; /* Solvers of every @Partial_solution, in the order of the @Solution */
+  vector<Synapse_iterator> partial_solver_output_maps;  /* Maps each output of the partial solvers into a slot in @neuron_data */
+  vector<vector<sdouble32>> worker_neuron_outputs; /* Buffers for the outputs of the partial solvers in every worker */
+  uint32 max_neuron_number = 0; /* The number of Neurons in the largest @Partial_solution */
+  uint32 worker_output_lanes = 1; /* The number of lanes every buffer in @worker_neuron_outputs is sized for */
   uint16 number_of_threads = 1;
+  uint32 required_input_size = 0; /* The number of network inputs the partial solutions read from */
+  bool checked = false;
+  Huge_page_allocator<sdouble32> neuron_data_allocator; /* Shared by the Neuron data of every job */
+  const Numa_topology* numa_topology = nullptr;
+  vector<uint16> partial_node; /* The node of the workers solving each @Partial_solution */
+  typedef vector<char, Aligned_allocator<char, page_bytes>> Node_weight_table;
+  vector<Node_weight_table> node_weight_tables; /* The copy of the weights of each @Partial_solution on its node, with more than one node */
+  vector<uint32> partial_first_stage; /* The index of the first stage of every @Partial_solution, and the number of stages at the end */
+  vector<uint32> stage_first_range; /* The index of the first range of every stage, and the number of ranges at the end */
+  static const uint32 staged_slot_none = std::numeric_limits<uint32>::max();
+  vector<uint32> partial_staged_slot; /* The slot in @Solve_job::staged_outputs of every @Partial_solution in multiple stages, or @staged_slot_none */
+  uint32 number_of_staged_slots = 0;
+  vector<Neuron_range> neuron_ranges; /* The Neuron ranges of every @Partial_solution, in the order of the @Solution */
+  static const uint32 row_not_gathered = std::numeric_limits<uint32>::max();
+  bool has_past_inputs = false; /* Whether any @Partial_solution has delayed inputs */
+  vector<sdouble32> past_data; /* The data of the Neurons read by delayed inputs from the previous input, by past index */
+  vector<sdouble32> batch_past_data; /* The same as @past_data for the lanes of the previous batch */
+  uint32 batch_size_in_past = 0; /* The number of lanes in @batch_past_data */
+
+  /**
+   * Scheduling state of the submitted inputs
+   */
+  std::mutex scheduler_mutex;
+  std::condition_variable jobs_finished;
+  Ring_buffer<shared_ptr<Solve_job>> jobs_in_flight; /* Submitted, but unfinished jobs in order of submission */
+  vector<Partial_task> partial_tasks; /* Ranges queued for the workers, under the index given to their task */
+  vector<uint32> free_partial_tasks; /* Indices in @partial_tasks not in use */
+  vector<shared_ptr<Solve_job>> idle_jobs; /* Finished jobs to be reused */
+  uint64 jobs_submitted = 0;
+  uint32 queued_tasks = 0; /* Tasks pushed to the workers, which haven't returned yet; the solver is only destroyed after them */
+  vector<uint64> partial_jobs_done; /* Number of jobs every @Partial_solution solved already */
+  unique_ptr<Worker_pool> owned_workers; /* The workers of the solver, unless a shared @Worker_pool is given in the @Service_context */
+  Worker_pool* workers;
 };
 
 } /* namespace sparse_net_library */
@@ -0,0 +1,53 @@
+#ifndef SOLUTION_STRUCTURE_VERIFIER_H
+#define SOLUTION_STRUCTURE_VERIFIER_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+
+/**
+ * @brief      Verifies the structure of a @Solution while its @Partial_solution elements are added row by row:
+ *             every Neuron shall be calculated by exactly one @Partial_solution, and its data shall be taken as input
+ *             only by the rows after the one calculating it. Delayed inputs read the data of the previous run,
+ *             so they may take any calculated Neuron; they are verified once every row is added.
+ */
+class Solution_structure_verifier{
+public:
+  Solution_structure_verifier(uint32 neuron_number_, uint32 output_neuron_number_)
+  : neuron_number(neuron_number_), output_neuron_number(output_neuron_number_)
+  , neuron_row(neuron_number_, -1)
+  { }
+
+  /**
+   * @brief      Adds a @Partial_solution of the given row, after every @Partial_solution of the previous rows
+   *
+   * @param[in]  partial    The partial solution
+   * @param[in]  row_index  The row of the @Partial_solution
+   *
+   * @return     Whether the @Partial_solution fits into the structure added so far
+   */
+  bool add_partial(const Partial_solution& partial, uint32 row_index);
+
+  /**
+   * @brief      Tells if the added @Partial_solution elements make up a whole @Solution: every output Neuron is calculated,
+   *             and the Neurons read by delayed inputs are calculated in any row
+   */
+  bool is_complete(void) const;
+
+private:
+  const uint32 neuron_number;
+  const uint32 output_neuron_number;
+  vector<sint32> neuron_row; /* The row calculating each Neuron */
+  vector<Synapse_interval> delayed_inputs; /* To be verified once every Neuron is placed */
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* SOLUTION_STRUCTURE_VERIFIER_H */
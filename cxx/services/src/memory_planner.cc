@@ -0,0 +1,275 @@
+#include "services/memory_planner.h"
+#include "services/synapse_iterator.h"
+
+#include <algorithm>
+
+namespace sparse_net_library{
+
+const uint32 Memory_planner::no_slot;
+
+Memory_planner::Memory_planner(const Solution& solution, uint32 slot_alignment_)
+: slot_alignment(slot_alignment_)
+, neuron_slot(solution.neuron_number(), no_slot)
+, neuron_past_index(solution.neuron_number(), no_slot)
+, partial_inputs(solution.partial_solutions_size())
+, partial_outputs(solution.partial_solutions_size())
+, row_inputs(solution.cols_size())
+, partial_inside_indices(solution.partial_solutions_size())
+, partial_index_synapse_numbers(solution.partial_solutions_size())
+{
+  if(0 == slot_alignment) throw "Slot alignment of 0!";
+  const uint32 first_output_neuron = solution.neuron_number() - solution.output_neuron_number();
+  vector<sint32> calculated_in_row = vector<sint32>(solution.neuron_number(), -1);
+  vector<sint32> last_read_in_row = vector<sint32>(solution.neuron_number(), -1);
+  vector<bool> read_delayed = vector<bool>(solution.neuron_number(), false); /* Whether the data of each Neuron is read in the next run */
+  vector<uint32> released_size = vector<uint32>(solution.neuron_number(), 1); /* Slots released together with each Neuron */
+  vector<vector<uint32>> released_in_row = vector<vector<uint32>>(solution.cols_size());
+
+  /* Find the rows calculating and last reading every Neuron */
+  int partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator){
+      const Partial_solution& partial = solution.partial_solutions(partial_iterator);
+      for(const Synapse_interval& output_synapse : partial.output_data())
+        for(uint32 neuron_index = output_synapse.starts(); neuron_index < (output_synapse.starts() + output_synapse.interval_size()); ++neuron_index)
+          calculated_in_row[neuron_index] = row_iterator;
+      for(const Synapse_interval& input_synapse : partial.input_data()){
+        if(input_synapse.delayed()){
+          for(uint32 neuron_index = input_synapse.starts(); neuron_index < (input_synapse.starts() + input_synapse.interval_size()); ++neuron_index)
+            read_delayed[neuron_index] = true;
+        }else if(!Synapse_iterator::is_index_input(input_synapse.starts())){
+          for(uint32 neuron_index = input_synapse.starts(); neuron_index < (input_synapse.starts() + input_synapse.interval_size()); ++neuron_index)
+            last_read_in_row[neuron_index] = std::max(last_read_in_row[neuron_index], row_iterator);
+        }
+      }
+      ++partial_iterator;
+    }
+  }
+
+  /* The inputs of a row are gathered before the row is solved, so the Neurons it calculates
+   * can take the slots of the Neurons it reads last. Neurons not read by any row are free after their own row.
+   * Output Neurons and Neurons read by delayed inputs keep their slots for the whole solution.
+   **/
+  for(uint32 neuron_index = 0; neuron_index < first_output_neuron; ++neuron_index){
+    if(read_delayed[neuron_index]) continue;
+    if(0 <= last_read_in_row[neuron_index]) released_in_row[last_read_in_row[neuron_index]].push_back(neuron_index);
+    else if((0 <= calculated_in_row[neuron_index])&&((calculated_in_row[neuron_index] + 1) < solution.cols_size()))
+      released_in_row[calculated_in_row[neuron_index] + 1].push_back(neuron_index);
+  }
+
+  /* Place the Neurons calculated by every @Partial_solution into one continuous range of slots, free in its row.
+   * The range starts at an aligned slot, and the padding after it is released together with its last Neuron;
+   * Since other ranges start aligned too, the padding is only reused once the aligned block containing it is free.
+   **/
+  partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    for(uint32 neuron_index : released_in_row[row_iterator])
+      release_slots(neuron_slot[neuron_index], released_size[neuron_index]);
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator){
+      const Partial_solution& partial = solution.partial_solutions(partial_iterator);
+      const uint32 range_size = aligned(partial.internal_neuron_number());
+      uint32 slot = reserve_slots(range_size);
+      uint32 last_neuron = 0;
+      for(const Synapse_interval& output_synapse : partial.output_data()){
+        for(uint32 neuron_index = output_synapse.starts(); neuron_index < (output_synapse.starts() + output_synapse.interval_size()); ++neuron_index){
+          neuron_slot[neuron_index] = slot++;
+          last_neuron = neuron_index;
+        }
+      }
+      if(0 < partial.internal_neuron_number())
+        released_size[last_neuron] += range_size - partial.internal_neuron_number();
+      ++partial_iterator;
+    }
+  }
+  for(uint32 neuron_index = first_output_neuron; neuron_index < solution.neuron_number(); ++neuron_index)
+    append_index(static_cast<sint32>(neuron_slot[neuron_index]), output_slots, 0);
+  uint32 number_of_past_neurons = 0;
+  for(uint32 neuron_index = 0; neuron_index < solution.neuron_number(); ++neuron_index){
+    if(read_delayed[neuron_index]){
+      neuron_past_index[neuron_index] = number_of_past_neurons++;
+      append_index(static_cast<sint32>(neuron_slot[neuron_index]), past_slots, 0);
+    }
+  }
+
+  /* Map the inputs and outputs of every @Partial_solution into the slots */
+  for(partial_iterator = 0; partial_iterator < solution.partial_solutions_size(); ++partial_iterator){
+    const Partial_solution& partial = solution.partial_solutions(partial_iterator);
+    for(const Synapse_interval& input_synapse : partial.input_data())
+      map_interval(input_synapse, partial_inputs[partial_iterator]);
+    for(const Synapse_interval& output_synapse : partial.output_data())
+      map_interval(output_synapse, partial_outputs[partial_iterator]);
+  }
+
+  /* Every row reads the union of the inputs of its @Partial_solution elements from a common buffer:
+   * the network inputs it needs in ascending order, followed by the Neuron slots it needs in ascending order,
+   * followed by the past indices of the delayed inputs it needs in ascending order
+   **/
+  partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    vector<uint32> needed_network_inputs; /* Collected and sorted per row, so planning stays linear in the size of the @Solution */
+    vector<uint32> needed_slots;
+    vector<uint32> needed_past;
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator){
+      const RepeatedPtrField<Synapse_interval>& inputs = partial_inputs[partial_iterator + col_iterator];
+      for(int synapse_iterator = 0; synapse_iterator < inputs.size(); ++synapse_iterator){
+        const Synapse_interval& input_synapse = inputs.Get(synapse_iterator);
+        if(input_synapse.delayed()){
+          for(uint32 past_index = input_synapse.starts(); past_index < (input_synapse.starts() + input_synapse.interval_size()); ++past_index)
+            needed_past.push_back(past_index);
+        }else{
+          Synapse_iterator(inputs).iterate_inline([&](int index){
+            if(Synapse_iterator::is_index_input(index))
+              needed_network_inputs.push_back(Synapse_iterator::input_index_from_synapse_index_unsafe(index));
+            else needed_slots.push_back(index);
+          }, synapse_iterator, 1);
+        }
+      }
+    }
+    std::sort(needed_network_inputs.begin(), needed_network_inputs.end());
+    needed_network_inputs.erase(std::unique(needed_network_inputs.begin(), needed_network_inputs.end()), needed_network_inputs.end());
+    std::sort(needed_slots.begin(), needed_slots.end());
+    needed_slots.erase(std::unique(needed_slots.begin(), needed_slots.end()), needed_slots.end());
+    std::sort(needed_past.begin(), needed_past.end());
+    needed_past.erase(std::unique(needed_past.begin(), needed_past.end()), needed_past.end());
+    for(uint32 input_index : needed_network_inputs)
+      append_index(Synapse_iterator::synapse_index_from_input_index(input_index), row_inputs[row_iterator], 0);
+    for(uint32 slot : needed_slots)
+      append_index(slot, row_inputs[row_iterator], 0);
+    for(uint32 past_index : needed_past)
+      append_index(past_index, row_inputs[row_iterator], 0, true);
+    max_row_input_size = std::max(max_row_input_size, static_cast<uint32>(
+      needed_network_inputs.size() + needed_slots.size() + needed_past.size()
+    ));
+
+    /* Point the Neuron inputs of the @Partial_solution elements into the row input */
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator){
+      const Partial_solution& partial = solution.partial_solutions(partial_iterator);
+      RepeatedPtrField<Synapse_interval>& inside_indices = partial_inside_indices[partial_iterator];
+      vector<sint32> partial_input_positions;
+      const RepeatedPtrField<Synapse_interval>& inputs = partial_inputs[partial_iterator];
+      for(int synapse_iterator = 0; synapse_iterator < inputs.size(); ++synapse_iterator){
+        const Synapse_interval& input_synapse = inputs.Get(synapse_iterator);
+        if(input_synapse.delayed()){ /* Past indices are after the Neuron slots in the row input */
+          for(uint32 past_index = input_synapse.starts(); past_index < (input_synapse.starts() + input_synapse.interval_size()); ++past_index){
+            partial_input_positions.push_back(needed_network_inputs.size() + needed_slots.size() + (
+              std::lower_bound(needed_past.begin(), needed_past.end(), past_index) - needed_past.begin()
+            ));
+          }
+        }else{
+          Synapse_iterator(inputs).iterate_inline([&](int index){
+            if(Synapse_iterator::is_index_input(index)){
+              partial_input_positions.push_back(std::lower_bound(
+                needed_network_inputs.begin(), needed_network_inputs.end(), Synapse_iterator::input_index_from_synapse_index_unsafe(index)
+              ) - needed_network_inputs.begin());
+            }else{ /* Neuron slots are after the network inputs in the row input */
+              partial_input_positions.push_back(needed_network_inputs.size() + (
+                std::lower_bound(needed_slots.begin(), needed_slots.end(), static_cast<uint32>(index)) - needed_slots.begin()
+              ));
+            }
+          }, synapse_iterator, 1);
+        }
+      }
+      if(static_cast<int>(partial.internal_neuron_number()) != partial.index_synapse_number_size())
+        throw "Invalid Partial solution!";
+      uint32 index_synapse_iterator_start = 0;
+      for(uint32 neuron_iterator = 0; neuron_iterator < partial.internal_neuron_number(); ++neuron_iterator){
+        const uint32 first_synapse_of_neuron = inside_indices.size();
+        if(partial.inside_indices_size() < static_cast<int>(index_synapse_iterator_start + partial.index_synapse_number(neuron_iterator)))
+          throw "Invalid Partial solution!";
+        if(0 < partial.index_synapse_number(neuron_iterator)){
+          Synapse_iterator(partial.inside_indices()).iterate_inline([&](int index){
+            if(Synapse_iterator::is_index_input(index)){
+              const uint32 input_index = Synapse_iterator::input_index_from_synapse_index_unsafe(index);
+              if(partial_input_positions.size() <= input_index) throw "Invalid Partial solution!";
+              append_index(
+                Synapse_iterator::synapse_index_from_input_index(partial_input_positions[input_index]),
+                inside_indices, first_synapse_of_neuron
+              );
+            }else append_index(index, inside_indices, first_synapse_of_neuron);
+          }, index_synapse_iterator_start, partial.index_synapse_number(neuron_iterator));
+        }
+        partial_index_synapse_numbers[partial_iterator].Add(inside_indices.size() - first_synapse_of_neuron);
+        index_synapse_iterator_start += partial.index_synapse_number(neuron_iterator);
+      }
+      ++partial_iterator;
+    }
+  }
+}
+
+void Memory_planner::append_index(sint32 index, RepeatedPtrField<Synapse_interval>& synapses, uint32 first_mergeable_synapse, bool delayed){
+  if(static_cast<int>(first_mergeable_synapse) < synapses.size()){
+    Synapse_interval& last_synapse = *synapses.Mutable(synapses.size() - 1);
+    if((last_synapse.delayed() == delayed)&&( /* Input synapses are iterated downwards, Neuron synapses upwards */
+      ((Synapse_iterator::is_index_input(index))&&(Synapse_iterator::is_index_input(last_synapse.starts()))
+        &&(index == static_cast<sint32>(last_synapse.starts() - last_synapse.interval_size())))
+      ||((!Synapse_iterator::is_index_input(index))&&(!Synapse_iterator::is_index_input(last_synapse.starts()))
+        &&(index == static_cast<sint32>(last_synapse.starts() + last_synapse.interval_size())))
+    )){
+      last_synapse.set_interval_size(last_synapse.interval_size() + 1);
+      return;
+    }
+  }
+  Synapse_interval* new_synapse = synapses.Add();
+  new_synapse->set_starts(index);
+  new_synapse->set_interval_size(1);
+  new_synapse->set_delayed(delayed);
+}
+
+uint32 Memory_planner::reserve_slots(uint32 size){
+  for(std::map<uint32,uint32>::iterator free_range = released_slots.begin(); free_range != released_slots.end(); ++free_range){
+    const uint32 slot = aligned(free_range->first);
+    const uint32 range_end = free_range->first + free_range->second;
+    if((slot + size) <= range_end){ /* First fit */
+      const uint32 range_start = free_range->first;
+      released_slots.erase(free_range);
+      if(range_start < slot) released_slots[range_start] = slot - range_start;
+      if((slot + size) < range_end) released_slots[slot + size] = range_end - (slot + size);
+      return slot;
+    }
+  }
+  if( /* A released range at the end of the buffer can be extended */
+    (0 < released_slots.size())
+    &&((released_slots.rbegin()->first + released_slots.rbegin()->second) == neuron_data_size)
+  ){
+    const uint32 range_start = released_slots.rbegin()->first;
+    const uint32 slot = aligned(range_start);
+    released_slots.erase(range_start);
+    if(range_start < slot) released_slots[range_start] = slot - range_start;
+    neuron_data_size = slot + size;
+    return slot;
+  }
+  const uint32 slot = aligned(neuron_data_size);
+  if(neuron_data_size < slot) release_slots(neuron_data_size, slot - neuron_data_size);
+  neuron_data_size = slot + size;
+  return slot;
+}
+
+void Memory_planner::release_slots(uint32 slot, uint32 size){
+  std::map<uint32,uint32>::iterator next_range = released_slots.lower_bound(slot);
+  if((released_slots.end() != next_range)&&((slot + size) == next_range->first)){
+    size += next_range->second;
+    next_range = released_slots.erase(next_range);
+  }
+  if(released_slots.begin() != next_range){
+    std::map<uint32,uint32>::iterator previous_range = std::prev(next_range);
+    if((previous_range->first + previous_range->second) == slot){
+      previous_range->second += size;
+      return;
+    }
+  }
+  released_slots[slot] = size;
+}
+
+void Memory_planner::map_interval(const Synapse_interval& interval, RepeatedPtrField<Synapse_interval>& mapped) const{
+  if(interval.delayed()){
+    for(uint32 neuron_index = interval.starts(); neuron_index < (interval.starts() + interval.interval_size()); ++neuron_index)
+      append_index(static_cast<sint32>(neuron_past_index[neuron_index]), mapped, 0, true);
+  }else if(Synapse_iterator::is_index_input(interval.starts())){
+    *mapped.Add() = interval;
+  }else{
+    for(uint32 neuron_index = interval.starts(); neuron_index < (interval.starts() + interval.interval_size()); ++neuron_index)
+      append_index(static_cast<sint32>(neuron_slot[neuron_index]), mapped, 0);
+  }
+}
+
+} /* namespace sparse_net_library */
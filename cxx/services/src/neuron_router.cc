@@ -13,7 +13,7 @@ Neuron_router::Neuron_router(const SparseNet& sparse_net) : net(sparse_net){
   neuron_states = vector<unique_ptr<atomic<uint32>>>(); /* Every Neuron has 0 child processed at first */
   neuron_number_of_inputs = vector<uint32>(net.neuron_array_size(),0);
   iteration = 1; /* Has to start with 1, otherwise values mix with neuron processed value */
-  for(int neuron_iterator; neuron_iterator < net.neuron_array_size(); ++neuron_iterator){
+  for(int neuron_iterator = 0; neuron_iterator < net.neuron_array_size(); ++neuron_iterator){
       for(int synapse_iterator = 0;
         synapse_iterator < net.neuron_array(neuron_iterator).input_indices_size();
         ++synapse_iterator
@@ -107,9 +107,16 @@ uint32 Neuron_router::get_next_neuron(vector<uint32>& visiting, bool strict){
       },[](int synapse_index){return true;});
     }
     number_of_processed_inputs = start_input_index_from;
-    iter.iterate_terminatable([&](int synapse_input_index)->bool{
+    uint32 synapse_iterator = start_synapse_iteration_from;
+    bool delayed_synapse = false;
+    iter.iterate_terminatable([&](unsigned int)->bool{
+      delayed_synapse = net.neuron_array(visiting.back()).input_indices(synapse_iterator).delayed();
+      ++synapse_iterator;
+      return true;
+    },[&](int synapse_input_index)->bool{
       if(
-        (Synapse_iterator::is_index_input(synapse_input_index))
+        (delayed_synapse) /* Delayed inputs read the data of the previous run, so they don't need to be solved before the Neuron */
+        ||(Synapse_iterator::is_index_input(synapse_input_index))
         ||(is_neuron_processed(synapse_input_index))
         ||((!strict)&&(is_neuron_reserved(synapse_input_index)))
         /*!Note: In non-strict mode usually the whole of the net is collected into the subset, which might be undesirable compared
@@ -148,11 +155,13 @@ void Neuron_router::add_neuron_into_subset(uint32 neuron_index){
   uint32 tmp_number = neuron_number_of_inputs[neuron_index];
   sdouble32 tmp_size = 0;
 
-  if(
-    is_neuron_solvable(neuron_index) /* If Neuron is solvable, and lock is successful */
-    &&((neuron_states[neuron_index])->compare_exchange_strong(tmp_number,neuron_state_reserved_value(neuron_index)))
-  ){ /* Push it into the Neuron subset */
-    std::lock_guard<std::mutex> lock(net_subset_mutex);
+  if(!is_neuron_solvable(neuron_index)) return;
+
+  /* Reserve and push the Neuron under the same lock, so the subset always contains the Neurons
+   * before the ones depending on them, even if they are reserved in different threads */
+  std::lock_guard<std::mutex> lock(net_subset_mutex);
+  if((neuron_states[neuron_index])->compare_exchange_strong(tmp_number,neuron_state_reserved_value(neuron_index))){
+    /* Push it into the Neuron subset */
     for(uint32 subset_neuron_index : net_subset){
       if(subset_neuron_index == neuron_index){
         return;
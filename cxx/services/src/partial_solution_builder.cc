@@ -6,38 +6,46 @@ void Partial_solution_builder::add_neuron_to_partial_solution(uint32 neuron_inde
   if(net.get().neuron_array_size() > static_cast<int>(neuron_index)){
     const Neuron& neuron = net.get().neuron_array(neuron_index);
     Synapse_interval temp_synapse_interval;
-    Synapse_iterator weight_iterator(neuron.input_weights());
     Synapse_iterator index_iterator(neuron.input_indices());
     /* Add a new Neuron into the partial solution */
     partial.get().set_internal_neuron_number(partial.get().internal_neuron_number() + 1);
     partial.get().add_actual_index(neuron_index);
+    inner_neuron_positions.emplace(neuron_index, partial.get().internal_neuron_number() - 1);
 
     /* Copy in Neuron parameters */
     partial.get().add_neuron_transfer_functions(neuron.transfer_function_idx());
     partial.get().add_memory_filter_index(partial.get().weight_table_size());
     partial.get().add_weight_table(net.get().weight_table(neuron.memory_filter_idx()));
-    partial.get().add_bias_index(partial.get().weight_table_size());
-    partial.get().add_weight_table(net.get().weight_table(neuron.bias_idx()));
+    partial.get().add_weight_sources(neuron.memory_filter_idx());
+    partial.get().add_neuron_memoryless(0.0 == net.get().weight_table(neuron.memory_filter_idx()));
+    temp_synapse_interval.set_starts(neuron.bias_idx());
+    temp_synapse_interval.set_interval_size(1);
+    partial.get().add_bias_index(copy_weight_synapse(temp_synapse_interval));
 
     /* Copy in weights from the net */
     partial.get().add_weight_synapse_number(neuron.input_weights_size());
-    weight_iterator.iterate([&](unsigned int weight_synapse_size){
-      temp_synapse_interval.set_starts(partial.get().weight_table_size());
-      temp_synapse_interval.set_interval_size(weight_synapse_size);
+    for(const Synapse_interval& weight_synapse : neuron.input_weights()){
+      temp_synapse_interval.set_starts(copy_weight_synapse(weight_synapse));
+      temp_synapse_interval.set_interval_size(weight_synapse.interval_size());
       *partial.get().add_weight_indices() = temp_synapse_interval;
-    },[&](int weight_index){
-      partial.get().add_weight_table(net.get().weight_table(weight_index));
-    });
+    }
 
     /* Copy in input data references */
     neuron_synapse_count = 0;
     previous_neuron_input_source = neuron_input_none; 
-    previous_neuron_input_index = input_synapse.size(); /* Input value to point above the size of the input */
+    previous_neuron_input_index = partial_input_size; /* Input value to point above the size of the input */
     uint32 index_synapse_previous_size = partial.get().inside_indices_size();
-    index_iterator.iterate([&](int neuron_input_index){ /* Put each Neuron input into the @Partial_solution */
-      if(!look_for_neuron_input(neuron_input_index)){
+    int neuron_synapse_iterator = 0;
+    bool delayed_input = false;
+    index_iterator.iterate([&](unsigned int){
+      delayed_input = neuron.input_indices(neuron_synapse_iterator).delayed();
+      ++neuron_synapse_iterator;
+    },[&](int neuron_input_index){ /* Put each Neuron input into the @Partial_solution */
+      if(!look_for_neuron_input(neuron_input_index, delayed_input)){
         /* Check if the partial input synapse needs to be closed */
-        if(!look_for_neuron_input_internally(neuron_input_index)){ /* if the Neuron is not found internally */
+        if( /* Delayed inputs are always taken from the @Partial_solution input, as the Neuron data of the previous run */
+          (delayed_input)||(!look_for_neuron_input_internally(neuron_input_index))
+        ){ /* if the Neuron is not found internally */
           if(
             (0 < partial_input_synapse_count)
             &&((
@@ -45,6 +53,8 @@ void Partial_solution_builder::add_neuron_to_partial_solution(uint32 neuron_inde
                 &&(input_synapse.back() != neuron_input_index+1)
               )||(
                 input_synapse.back() != neuron_input_index-1
+              )||(
+                partial.get().input_data(partial.get().input_data_size()-1).delayed() != delayed_input
             ))
           ){
             partial_input_synapse_count = 0; /* Close synapse! */
@@ -52,25 +62,27 @@ void Partial_solution_builder::add_neuron_to_partial_solution(uint32 neuron_inde
           if(0 < neuron_synapse_count){
             if(
               (neuron_input_external != previous_neuron_input_source)
-              ||(static_cast<int>(input_synapse.size()-1) != previous_neuron_input_index)
+              ||(static_cast<int>(partial_input_size-1) != previous_neuron_input_index)
             )neuron_synapse_count = 0; /* Close synapse! */
           }
-          previous_neuron_input_index = input_synapse.size(); /* Update previous neuron input source as well */
+          previous_neuron_input_index = partial_input_size; /* Update previous neuron input source as well */
           previous_neuron_input_source = neuron_input_external;/* since the input was added to be taken from the @Partial_solution inputs */
           add_to_synapse( /* Neural input shall be added from the input of the @Partial_solution */
-            Synapse_iterator::synapse_index_from_input_index(input_synapse.size()),
+            Synapse_iterator::synapse_index_from_input_index(partial_input_size),
             neuron_synapse_count, partial.get().mutable_inside_indices()
           );
           add_to_synapse(
             neuron_input_index, partial_input_synapse_count,
             partial.get().mutable_input_data()
           );
+          partial.get().mutable_input_data(partial.get().input_data_size()-1)->set_delayed(delayed_input);
+          partial_input_positions.emplace(get_input_key(neuron_input_index, delayed_input), partial_input_size);
+          ++partial_input_size;
         }/* Neuron input was found internally in the @Partial_solution */
       }/* Neuron input was found in the @Partial_solution inputs, continue to look for it.. */
     });
 
-    if(0 < (partial.get().inside_indices_size() - index_synapse_previous_size))
-      partial.get().add_index_synapse_number(partial.get().inside_indices_size() - index_synapse_previous_size);
+    partial.get().add_index_synapse_number(partial.get().inside_indices_size() - index_synapse_previous_size);
 
     if( /* In case th latest input synapse is of 0 length, remove it */
       (0 < partial.get().input_data_size())
@@ -80,19 +92,75 @@ void Partial_solution_builder::add_neuron_to_partial_solution(uint32 neuron_inde
   }else throw "Neuron index is out of bounds from net neuron array!";
 }
 
-bool Partial_solution_builder::look_for_neuron_input(int neuron_input_index){
-  uint32 candidate_synapse_index = input_synapse.size();
+uint32 Partial_solution_builder::copy_weight_synapse(const Synapse_interval& weight_synapse){
+  const uint64 synapse_key = (static_cast<uint64>(static_cast<uint32>(weight_synapse.starts())) << 32) | weight_synapse.interval_size();
+  const auto copied_synapse = copied_weight_synapses.find(synapse_key);
+  if(copied_weight_synapses.end() != copied_synapse) return copied_synapse->second;
 
-  input_synapse.iterate_terminatable([&](int synapse_index){
-    if(candidate_synapse_index == input_synapse.size()) candidate_synapse_index = 0;
-    if(synapse_index == neuron_input_index){
-      return false; /* No need to continue Synapse iteration, found the right candidate! */
-    }else{
-      ++candidate_synapse_index; /* Step the candidate iterator forward to the next index in the input array */
-      return true;
-    }
+  const uint32 partial_start = partial.get().weight_table_size();
+  for(uint32 weight_index = 0; weight_index < weight_synapse.interval_size(); ++weight_index){
+    partial.get().add_weight_table(net.get().weight_table(weight_synapse.starts() + weight_index));
+    partial.get().add_weight_sources(weight_synapse.starts() + weight_index);
+  }
+  copied_weight_synapses.emplace(synapse_key, partial_start);
+  return partial_start;
+}
+
+const uint64 Partial_solution_builder::size_tolerance_bytes;
+
+uint64 Partial_solution_builder::get_partial_size_bytes(const Partial_solution& partial){
+  return(
+    sizeof(Partial_solution)
+    + repeated_field_bytes(partial.weight_table()) + repeated_field_bytes(partial.memory_filter_index())
+    + repeated_field_bytes(partial.bias_index()) + repeated_field_bytes(partial.weight_sources())
+    + repeated_field_bytes(partial.actual_index()) + repeated_field_bytes(partial.index_synapse_number())
+    + repeated_field_bytes(partial.weight_synapse_number()) + repeated_field_bytes(partial.neuron_transfer_functions())
+    + repeated_field_bytes(partial.neuron_memoryless())
+    + repeated_field_bytes(partial.input_data()) + repeated_field_bytes(partial.output_data())
+    + repeated_field_bytes(partial.inside_indices()) + repeated_field_bytes(partial.weight_indices())
+    + string_bytes(partial.half_weight_table())
+  );
+}
+
+void Partial_solution_builder::map_partial_indices(void){
+  int input_synapse_iterator = 0;
+  bool delayed_input = false;
+  input_synapse.iterate([&](unsigned int){
+    delayed_input = partial.get().input_data(input_synapse_iterator).delayed();
+    ++input_synapse_iterator;
+  },[&](int synapse_index){
+    partial_input_positions.emplace(get_input_key(synapse_index, delayed_input), partial_input_size);
+    ++partial_input_size;
   });
-  if(candidate_synapse_index < input_synapse.size()){ /* Found the neuron input in the candidate synapse inputs */
+  for(uint32 inner_neuron_index = 0; inner_neuron_index < partial.get().internal_neuron_number(); ++inner_neuron_index)
+    inner_neuron_positions.emplace(partial.get().actual_index(inner_neuron_index), inner_neuron_index);
+
+  /* Weight intervals already copied in are found again through the net weights they were copied from */
+  if(partial.get().weight_sources_size() == partial.get().weight_table_size()){
+    for(const double bias_index : partial.get().bias_index())
+      map_weight_synapse(static_cast<uint32>(bias_index), 1);
+    for(const Synapse_interval& weight_synapse : partial.get().weight_indices())
+      map_weight_synapse(weight_synapse.starts(), weight_synapse.interval_size());
+  }
+}
+
+void Partial_solution_builder::map_weight_synapse(uint32 partial_start, uint32 interval_size){
+  if(
+    (0 == interval_size)
+    ||(static_cast<uint32>(partial.get().weight_sources_size()) < (partial_start + interval_size))
+  )return;
+  const uint32 net_start = partial.get().weight_sources(partial_start);
+  for(uint32 weight_index = 1; weight_index < interval_size; ++weight_index)
+    if((net_start + weight_index) != partial.get().weight_sources(partial_start + weight_index))
+      return; /* Not copied from a single interval of the net */
+  const uint64 synapse_key = (static_cast<uint64>(net_start) << 32) | interval_size;
+  copied_weight_synapses.emplace(synapse_key, partial_start);
+}
+
+bool Partial_solution_builder::look_for_neuron_input(int neuron_input_index, bool delayed){
+  const auto found_input = partial_input_positions.find(get_input_key(neuron_input_index, delayed));
+  if(partial_input_positions.end() != found_input){ /* Found the neuron input in the candidate synapse inputs */
+    const uint32 candidate_synapse_index = found_input->second;
     /* Check if the newly added Neuron synapse can be continued based on value, or a new Synapse needs to be added */
     if(0 < neuron_synapse_count){
       if(
@@ -111,31 +179,25 @@ bool Partial_solution_builder::look_for_neuron_input(int neuron_input_index){
 }
 
 bool Partial_solution_builder::look_for_neuron_input_internally(uint32 neuron_input_index){
-
-  using std::for_each;
-
-  uint32 inner_neuron_index = 0;
-  for(uint32 i = 0; i < partial.get().internal_neuron_number(); ++i){
-    if(neuron_input_index != partial.get().actual_index(i))++inner_neuron_index;
-    else{
-      if(0 < neuron_synapse_count){
-        if(
-          (neuron_input_internal != previous_neuron_input_source)
-          ||(static_cast<int>(inner_neuron_index)-1 != previous_neuron_input_index)
-        ){
-          neuron_synapse_count = 0; /* Close synapse! */
-        }
+  const auto found_neuron = inner_neuron_positions.find(neuron_input_index);
+  if(inner_neuron_positions.end() != found_neuron){
+    const uint32 inner_neuron_index = found_neuron->second;
+    if(0 < neuron_synapse_count){
+      if(
+        (neuron_input_internal != previous_neuron_input_source)
+        ||(static_cast<int>(inner_neuron_index)-1 != previous_neuron_input_index)
+      ){
+        neuron_synapse_count = 0; /* Close synapse! */
       }
-      previous_neuron_input_index = inner_neuron_index;
-      previous_neuron_input_source = neuron_input_internal;
-      add_to_synapse( /* The Neuron input points to an internal Neuron (no conversion to input synapse index) */
-        inner_neuron_index, neuron_synapse_count,
-        partial.get().mutable_inside_indices()
-      );
-      return true;
     }
-  }
-  return false;
+    previous_neuron_input_index = inner_neuron_index;
+    previous_neuron_input_source = neuron_input_internal;
+    add_to_synapse( /* The Neuron input points to an internal Neuron (no conversion to input synapse index) */
+      inner_neuron_index, neuron_synapse_count,
+      partial.get().mutable_inside_indices()
+    );
+    return true;
+  }else return false;
 }
 
-} /* namespace sparse_net_library */
\ No newline at end of file
+} /* namespace sparse_net_library */
@@ -5,143 +5,653 @@
 
 #include "models/transfer_function.h"
 #include "models/spike_function.h"
+#include "models/half_float.h"
+#include "models/input_transformer.h"
 
 namespace sparse_net_library {
 
+const uint32 Partial_solution_solver::max_neuron_block;
+
+namespace{
+
+/**
+ * @brief      Reads the weights of a @Partial_solution stored in @weight_table, or from the given copy of it
+ */
+class Double_weight_table{
+public:
+  Double_weight_table(const Partial_solution& partial, const void* weight_data)
+  : table((nullptr != weight_data)?(static_cast<const sdouble32*>(weight_data)):(partial.weight_table().data()))
+  , table_size(partial.weight_table_size())
+  { }
+
+  sdouble32 operator[](uint32 index) const{
+    return table[index];
+  }
+
+  int size(void) const{
+    return table_size;
+  }
+
+private:
+  const sdouble32* table;
+  int table_size;
+};
+
+/**
+ * @brief      Reads the weights of a @Partial_solution stored in @half_weight_table, or from the given copy of it,
+ *             widening them on the fly
+ */
+template<weight_storages storage>
+class Half_weight_table{
+public:
+  Half_weight_table(const Partial_solution& partial, const void* weight_data)
+  : table((nullptr != weight_data)?(static_cast<const char*>(weight_data)):(partial.half_weight_table().data()))
+  , table_size(partial.half_weight_table().size() / sizeof(uint16))
+  { }
+
+  sdouble32 operator[](uint32 index) const{
+    return Half_float::to_double<storage>(Half_float::get_half(table, index));
+  }
+
+  int size(void) const{
+    return table_size;
+  }
+
+private:
+  const char* table;
+  int table_size;
+};
+
+/**
+ * @brief      Calls the given function with the reader of the weights in the format of the @Partial_solution,
+ *             so the solving kernels are compiled for every format without checking it for every weight.
+ *             The weights are read from the given copy of the weight table, unless it is nullptr.
+ */
+template<typename Function>
+void with_weight_table(const Partial_solution& partial, const void* weight_data, Function function){
+  switch(partial.weight_storage()){
+    case WEIGHT_STORAGE_FP16: function(Half_weight_table<WEIGHT_STORAGE_FP16>(partial, weight_data)); break;
+    case WEIGHT_STORAGE_BF16: function(Half_weight_table<WEIGHT_STORAGE_BF16>(partial, weight_data)); break;
+    default: function(Double_weight_table(partial, weight_data));
+  }
+}
+
+} /* namespace */
+
+void Partial_solution_solver::classify_neurons(void){
+  number_of_neurons_with_memory = 0;
+  stateful_neurons.resize(detail.get().internal_neuron_number());
+  for(uint32 neuron_iterator = 0; neuron_iterator < detail.get().internal_neuron_number(); ++neuron_iterator){
+    neuron_starts[neuron_iterator].memory_index = number_of_neurons_with_memory;
+    stateful_neurons[neuron_iterator] = has_memory(neuron_iterator);
+    if(stateful_neurons[neuron_iterator]) ++number_of_neurons_with_memory;
+  }
+}
+
 void Partial_solution_solver::reset(void){
-  neuron_output = vector<sdouble32>(detail.get().internal_neuron_number());
-  input_iterator = Synapse_iterator(detail.get().input_data());
-  internal_iterator = Synapse_iterator(detail.get().inside_indices());
-  uint32 input_size = 0;
-  input_iterator.iterate([&](unsigned int synapse_size){
-    input_size += synapse_size;
-  },[&](int synapse_index){});
-  collected_input_data = vector<sdouble32>(input_size);
+  classify_neurons();
+  neuron_memory.assign(number_of_neurons_with_memory, 0.0);
+  batch_neuron_memory.clear();
+  batch_size_in_memory = 0;
+}
+
+void Partial_solution_solver::refresh_neurons(void){
+  const vector<uint8> previous_stateful_neurons = stateful_neurons;
+  vector<uint32> previous_memory_index(neuron_starts.size());
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_starts.size(); ++neuron_iterator)
+    previous_memory_index[neuron_iterator] = neuron_starts[neuron_iterator].memory_index;
+  classify_neurons();
+  if(previous_stateful_neurons == stateful_neurons) return;
+
+  /* Neurons keeping their memory keep its value, Neurons getting memory start from zero */
+  vector<sdouble32> previous_memory(number_of_neurons_with_memory, 0.0);
+  vector<sdouble32> previous_batch_memory(number_of_neurons_with_memory * batch_size_in_memory, 0.0);
+  previous_memory.swap(neuron_memory);
+  previous_batch_memory.swap(batch_neuron_memory);
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_starts.size(); ++neuron_iterator){
+    if(previous_stateful_neurons[neuron_iterator] && stateful_neurons[neuron_iterator]){
+      const uint32 memory_index = neuron_starts[neuron_iterator].memory_index;
+      neuron_memory[memory_index] = previous_memory[previous_memory_index[neuron_iterator]];
+      std::copy_n(
+        previous_batch_memory.begin() + (previous_memory_index[neuron_iterator] * batch_size_in_memory),
+        batch_size_in_memory, batch_neuron_memory.begin() + (memory_index * batch_size_in_memory)
+      );
+    }
+  }
+}
+
+void Partial_solution_solver::scan_neuron_ranges(void){
+  const uint32 neuron_number = detail.get().internal_neuron_number();
+  neuron_starts = vector<Neuron_start>(neuron_number);
+  vector<uint32> first_internal_input(neuron_number); /* The first Neuron inside the partial each Neuron takes input from */
+  wavefronts.clear();
+  packed_inside_indices = Packed_synapses();
+  packed_input_data = Packed_synapses();
+  if(!shared_input) /* Only the solvers collecting their own inputs read the inputs of the @Partial_solution */
+    packed_input_data.pack(detail.get().input_data(), 0, detail.get().input_data_size());
+  uint32 wavefront_start = 0;
+  uint32 index_synapse_iterator_start = 0;
+  uint32 weight_synapse_iterator_start = 0;
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_number; ++neuron_iterator){
+    neuron_starts[neuron_iterator].index_synapse = index_synapse_iterator_start;
+    neuron_starts[neuron_iterator].packed_index_synapse = packed_inside_indices.pack(
+      *inside_indices, index_synapse_iterator_start, index_synapse_numbers.get().Get(neuron_iterator)
+    );
+    neuron_starts[neuron_iterator].weight_synapse = weight_synapse_iterator_start;
+    first_internal_input[neuron_iterator] = neuron_iterator;
+    bool depends_on_wavefront = false; /* A Neuron taking input from its own wavefront starts the next one */
+    for(uint32 synapse_iterator = 0; synapse_iterator < index_synapse_numbers.get().Get(neuron_iterator); ++synapse_iterator){
+      const Synapse_interval& synapse = inside_indices->Get(index_synapse_iterator_start + synapse_iterator);
+      if((!Synapse_iterator::is_index_input(synapse.starts()))&&(0 < synapse.interval_size())){
+        first_internal_input[neuron_iterator] = std::min(first_internal_input[neuron_iterator], static_cast<uint32>(synapse.starts()));
+        depends_on_wavefront |= (wavefront_start < (synapse.starts() + synapse.interval_size()));
+      }
+    }
+    if(depends_on_wavefront){
+      wavefront_start = neuron_iterator;
+      wavefronts.push_back(wavefront_start);
+    }
+    index_synapse_iterator_start += index_synapse_numbers.get().Get(neuron_iterator);
+    weight_synapse_iterator_start += detail.get().weight_synapse_number(neuron_iterator);
+  }
+  packed_inside_indices.shrink_to_fit();
+  packed_input_data.shrink_to_fit();
+  same_input_neurons = vector<uint32>(neuron_number, 1u);
+  for(uint32 neuron_iterator = neuron_number - 1; 0 < neuron_iterator; --neuron_iterator){
+    const uint32 previous_neuron = neuron_iterator - 1;
+    const uint32 synapse_number = index_synapse_numbers.get().Get(neuron_iterator);
+    bool same_inputs = (synapse_number == index_synapse_numbers.get().Get(previous_neuron));
+    for(uint32 synapse_iterator = 0; (same_inputs && (synapse_iterator < synapse_number)); ++synapse_iterator){
+      const Synapse_interval& synapse = inside_indices->Get(neuron_starts[neuron_iterator].index_synapse + synapse_iterator);
+      const Synapse_interval& previous_synapse = inside_indices->Get(neuron_starts[previous_neuron].index_synapse + synapse_iterator);
+      same_inputs = ((synapse.starts() == previous_synapse.starts())&&(synapse.interval_size() == previous_synapse.interval_size()));
+    }
+    if(same_inputs) same_input_neurons[previous_neuron] = same_input_neurons[neuron_iterator] + 1;
+  }
+  independent_neurons.clear();
+  uint32 first_input_after = neuron_number; /* The first internal input of the Neurons after the one under @neuron_iterator */
+  for(uint32 neuron_iterator = neuron_number - 1; 0 < neuron_iterator; --neuron_iterator){
+    first_input_after = std::min(first_input_after, first_internal_input[neuron_iterator]);
+    if(neuron_iterator <= first_input_after) independent_neurons.push_back(neuron_iterator);
+  }
+  std::reverse(independent_neurons.begin(), independent_neurons.end());
+}
+
+bool Partial_solution_solver::is_neuron_range_valid(uint32 first_neuron, uint32 end_neuron, bool previous_wavefronts_solved) const{
+  if(!((first_neuron < end_neuron)&&(end_neuron <= detail.get().internal_neuron_number()))) return false;
+  if((0 == first_neuron)||(std::binary_search(independent_neurons.begin(), independent_neurons.end(), first_neuron))) return true;
+  if(previous_wavefronts_solved){ /* Any range starting at a wavefront, or lying inside one */
+    vector<uint32>::const_iterator next_wavefront = std::upper_bound(wavefronts.begin(), wavefronts.end(), first_neuron);
+    return(
+      ((wavefronts.begin() != next_wavefront)&&(first_neuron == *(next_wavefront - 1)))
+      ||(wavefronts.end() == next_wavefront)||(end_neuron <= *next_wavefront)
+    );
+  }
+  return false;
+}
+
+void Partial_solution_solver::set_input_transforms(const RepeatedPtrField<Input_transform>& transforms){
+  if(transforms.empty()){
+    input_transforms = nullptr;
+  }else{
+    if(
+      (static_cast<uint32>(transforms.size()) < get_required_input_size())
+      ||(!std::all_of(transforms.begin(), transforms.end(), Input_transformer::is_valid))
+    )throw "Invalid input transforms!";
+    input_transforms = &transforms;
+  }
+}
+
+uint32 Partial_solution_solver::get_required_input_size(void) const{
+  uint32 required_input_size = 0;
+  input_iterator.skim_inline([&](int synapse_starts, unsigned int synapse_size){
+    if((0 < synapse_size)&&(Synapse_iterator::is_index_input(synapse_starts))){
+      required_input_size = std::max(
+        required_input_size, Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_starts) + synapse_size
+      );
+    }
+  });
+  return required_input_size;
+}
+
+void Partial_solution_solver::collect_input_data(const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data){
+  if(shared_input) throw "The inputs of the Partial solution are shared!";
+  if(collected_input_data.size() != input_size) collected_input_data = vector<sdouble32>(input_size);
+  collect_input_data(input_data, neuron_data, collected_input_data);
+}
+
+void Partial_solution_solver::collect_input_data(
+  const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data, vector<sdouble32>& collected_input
+) const{
+  if(shared_input) throw "The inputs of the Partial solution are shared!";
+  if(checked){
+    if(collected_input.size() < input_size) throw "Buffer is too small for the Partial solution input!";
+    if(nullptr != input_transforms) collect_input_data_internal<true, true>(input_data, neuron_data, collected_input);
+    else collect_input_data_internal<true, false>(input_data, neuron_data, collected_input);
+  }else{
+    if(nullptr != input_transforms) collect_input_data_internal<false, true>(input_data, neuron_data, collected_input);
+    else collect_input_data_internal<false, false>(input_data, neuron_data, collected_input);
+  }
 }
 
-void Partial_solution_solver::collect_input_data(vector<sdouble32>& input_data, vector<sdouble32> neuron_data){
+template<bool checked_access, bool transformed>
+void Partial_solution_solver::collect_input_data_internal(
+  const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data, vector<sdouble32>& collected_input
+) const{
   uint32 input_index = 0;
-  input_iterator.iterate([&](int synapse_index){
+  packed_input_data.iterate_inline([&](int synapse_index){
     if(Synapse_iterator::is_index_input(synapse_index)){ /* If @Partial_solution input is from the network input */
-      collected_input_data[input_index] = input_data[Synapse_iterator::input_index_from_synapse_index(synapse_index)];
-    }else if(neuron_data.size() > static_cast<std::size_t>(synapse_index)){  /* If @Partial_solution input is from the previous row */
-      collected_input_data[input_index] = neuron_data[synapse_index];
+      if(checked_access && (input_data.size() <= Synapse_iterator::input_index_from_synapse_index(synapse_index)))
+        throw "Partial solution input index is out of bounds of the network input!";
+      const uint32 network_input_index = Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_index);
+      if(transformed){
+        collected_input[input_index] = Input_transformer::get_value(
+          input_transforms->Get(network_input_index), input_data[network_input_index]
+        );
+      }else collected_input[input_index] = input_data[network_input_index];
+    }else{  /* If @Partial_solution input is from the previous row */
+      if(checked_access && (neuron_data.size() <= static_cast<std::size_t>(synapse_index)))
+        throw "Partial solution input index is out of bounds of the Neuron data!";
+      collected_input[input_index] = neuron_data[synapse_index];
     }
     ++input_index;
-  });
+  }, 0, detail.get().input_data_size());
 }
 
 vector<sdouble32> Partial_solution_solver::solve(){
-  sdouble32 new_neuron_data = 0;
-  sdouble32 new_neuron_input;
-  uint32 index_synapse_iterator_start = 0; /* Which is the first synapse belonging to the neuron under @neuron_iterator */
-  uint32 weight_synapse_index = 0; /* Which synapse is being processed inside the Neuron */
-  uint32 weight_index = 0;
-
-  for(uint16 neuron_iterator = 0; neuron_iterator < detail.get().internal_neuron_number(); ++neuron_iterator){
-    new_neuron_data = 0;
-    internal_iterator.iterate_unsafe([&](int synapse_index){
+  if(neuron_output.size() != detail.get().internal_neuron_number())
+    neuron_output = vector<sdouble32>(detail.get().internal_neuron_number());
+  if(collected_input_data.size() != input_size) collected_input_data = vector<sdouble32>(input_size);
+  solve(collected_input_data, neuron_output);
+  return neuron_output;
+}
+
+void Partial_solution_solver::solve(const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer){
+  solve(collected_input, neuron_output_buffer, 0, detail.get().internal_neuron_number());
+}
+
+void Partial_solution_solver::solve(
+  const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 first_neuron, uint32 end_neuron,
+  bool previous_wavefronts_solved
+){
+  if(checked){
+    if(
+      (collected_input.size() < input_size)
+      ||(neuron_output_buffer.size() < detail.get().internal_neuron_number())
+    )throw "Buffer is too small for the Partial solution!";
+    if(!is_neuron_range_valid(first_neuron, end_neuron, previous_wavefronts_solved)) throw "Invalid Neuron range for the Partial solution!";
+    with_weight_table(detail.get(), weight_data, [&](const auto& weights){
+      solve_internal<true>(weights, collected_input, neuron_output_buffer, first_neuron, end_neuron);
+    });
+  }else{
+    with_weight_table(detail.get(), weight_data, [&](const auto& weights){
+      solve_internal<false>(weights, collected_input, neuron_output_buffer, first_neuron, end_neuron);
+    });
+  }
+}
+
+template<bool checked_access, uint32 block_size, typename Weight_table>
+void Partial_solution_solver::sum_neuron_inputs(
+  const Weight_table& weights, const vector<sdouble32>& collected_input, const vector<sdouble32>& neuron_output_buffer,
+  uint32 first_neuron, sdouble32* neuron_data
+) const{
+  const Partial_solution& partial = detail.get();
+  uint32 weight_synapse_index[block_size]; /* Which synapse is being processed inside every Neuron of the block */
+  const Synapse_interval* weight_synapse[block_size]; /* The synapse under @weight_synapse_index, read from the @Partial_solution once per synapse */
+  uint32 weight_index[block_size];
+  for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator){
+    weight_synapse_index[block_iterator] = neuron_starts[first_neuron + block_iterator].weight_synapse;
+    weight_synapse[block_iterator] = first_weight_synapse(first_neuron + block_iterator);
+    weight_index[block_iterator] = 0;
+    neuron_data[block_iterator] = 0;
+  }
+  if(0 < index_synapse_numbers.get().Get(first_neuron)){
+    packed_inside_indices.iterate_inline([&](int synapse_index){
+      sdouble32 new_neuron_input;
       if(Synapse_iterator::is_index_input(synapse_index)){ /* Neuron gets its input from the partialsolution input */
-        new_neuron_input = collected_input_data[Synapse_iterator::input_index_from_synapse_index(synapse_index)];
+        if(checked_access && (collected_input.size() <= Synapse_iterator::input_index_from_synapse_index(synapse_index)))
+          throw "Neuron input index is out of bounds of the Partial solution input!";
+        new_neuron_input = collected_input[Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_index)];
       }else{ /* Neuron gets its input internaly */
-        new_neuron_input = neuron_output[synapse_index];
+        if(checked_access && (static_cast<int>(first_neuron) <= synapse_index))
+          throw "Neuron takes its input from itself or a Neuron after it inside the Partial solution!";
+        new_neuron_input = neuron_output_buffer[synapse_index];
+      }
+
+      for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator){ /* Data of the input * weight of the input */
+        const uint32 neuron_index = first_neuron + block_iterator;
+        if(checked_access && (
+          (weight_synapse_index[block_iterator] >= (neuron_starts[neuron_index].weight_synapse + partial.weight_synapse_number(neuron_index)))
+          ||(weights.size() <= static_cast<int>(weight_synapse[block_iterator]->starts() + weight_index[block_iterator]))
+        ))throw "Neuron weight index is out of bounds!";
+        neuron_data[block_iterator] += new_neuron_input * weights[weight_synapse[block_iterator]->starts() + weight_index[block_iterator]];
+
+        ++weight_index[block_iterator]; /* Step the Weight index forwards */
+        if(weight_index[block_iterator] >= weight_synapse[block_iterator]->interval_size()){
+          weight_index[block_iterator] = 0; /* In case the next weight would ascend above the current patition, go to next one */
+          ++weight_synapse_index[block_iterator];
+          weight_synapse[block_iterator] = next_weight_synapse(weight_synapse_index[block_iterator], weight_synapse[block_iterator]);
+          /*!Note: The number of weights and indexes are matching for every Neuron, because the structure
+           * is verified in the constructor.
+           **/
+        }
       }
+    },neuron_starts[first_neuron].packed_index_synapse, index_synapse_numbers.get().Get(first_neuron));
+  }
+  for(uint32 block_iterator = 0; checked_access && (block_iterator < block_size); ++block_iterator){
+    const uint32 neuron_index = first_neuron + block_iterator;
+    if(
+      (0 != weight_index[block_iterator])
+      ||(weight_synapse_index[block_iterator] != (neuron_starts[neuron_index].weight_synapse + partial.weight_synapse_number(neuron_index)))
+    )throw "Number of Neuron weights don't match the number of Neuron inputs!";
+  }
+}
+
+template<bool checked_access, typename Weight_table>
+void Partial_solution_solver::solve_internal(
+  const Weight_table& weights,
+  const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 first_neuron, uint32 end_neuron
+){
+  const Partial_solution& partial = detail.get();
+  sdouble32 neuron_data[max_neuron_block];
+  uint32 neuron_iterator = first_neuron;
+  while(neuron_iterator < end_neuron){
+    const uint32 block_size = get_neuron_block(neuron_iterator, end_neuron);
+    if(max_neuron_block == block_size)
+      sum_neuron_inputs<checked_access, max_neuron_block>(weights, collected_input, neuron_output_buffer, neuron_iterator, neuron_data);
+    else if((max_neuron_block / 2) == block_size)
+      sum_neuron_inputs<checked_access, (max_neuron_block / 2)>(weights, collected_input, neuron_output_buffer, neuron_iterator, neuron_data);
+    else sum_neuron_inputs<checked_access, 1>(weights, collected_input, neuron_output_buffer, neuron_iterator, neuron_data);
+
+    for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator, ++neuron_iterator){
+      /* Add bias */
+      if(checked_access && (weights.size() <= partial.bias_index(neuron_iterator)))
+        throw "Neuron bias index is out of bounds!";
+      sdouble32 new_neuron_data = neuron_data[block_iterator] + weights[partial.bias_index(neuron_iterator)];
 
-      new_neuron_data += new_neuron_input * /* Data of the input * weight of the input * */
-      detail.get().weight_table(
-        detail.get().weight_indices(weight_synapse_index).starts() + weight_index
+      /* Apply transfer function */
+      new_neuron_data = Transfer_function::get_value(
+        partial.neuron_transfer_functions(neuron_iterator), new_neuron_data
       );
 
-      ++weight_index; /* Step the Weight index forwards */
-      if(weight_index >= detail.get().weight_indices(weight_synapse_index).interval_size()){
-        weight_index = 0; /* In case the next weight would ascend above the current patition, go to next one */
-        ++weight_synapse_index;
+      /* Apply memory filter */
+      if(stateful_neurons[neuron_iterator]){
+        if(checked_access && (weights.size() <= partial.memory_filter_index(neuron_iterator)))
+          throw "Neuron memory filter index is out of bounds!";
+        const uint32 memory_index = neuron_starts[neuron_iterator].memory_index; /* Which element of @neuron_memory belongs to the Neuron */
+        neuron_memory[memory_index] = Spike_function::get_value(
+          weights[partial.memory_filter_index(neuron_iterator)],
+          new_neuron_data,
+          neuron_memory[memory_index]
+        );
+        neuron_output_buffer[neuron_iterator] = neuron_memory[memory_index];
+      }else{ /* A stateless Neuron is its transfer function value, as its memory filter is zero */
+        neuron_output_buffer[neuron_iterator] = new_neuron_data;
+      }
+    }
+  } /* Go through the neurons */
+}
+
+void Partial_solution_solver::collect_batch_input_data(
+  const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data,
+  vector<sdouble32>& collected_input, uint32 batch_size
+) const{
+  if(shared_input) throw "The inputs of the Partial solution are shared!";
+  if(checked){
+    if(collected_input.size() < (input_size * batch_size)) throw "Buffer is too small for the Partial solution input!";
+    if(nullptr != input_transforms) collect_batch_input_data_internal<true, true>(input_data, neuron_data, collected_input, batch_size);
+    else collect_batch_input_data_internal<true, false>(input_data, neuron_data, collected_input, batch_size);
+  }else{
+    if(nullptr != input_transforms) collect_batch_input_data_internal<false, true>(input_data, neuron_data, collected_input, batch_size);
+    else collect_batch_input_data_internal<false, false>(input_data, neuron_data, collected_input, batch_size);
+  }
+}
+
+template<bool checked_access, bool transformed>
+void Partial_solution_solver::collect_batch_input_data_internal(
+  const vector<sdouble32>& input_data, const vector<sdouble32>& neuron_data,
+  vector<sdouble32>& collected_input, uint32 batch_size
+) const{
+  vector<sdouble32>::iterator collected_lanes = collected_input.begin();
+  packed_input_data.iterate_inline([&](int synapse_index){
+    if(Synapse_iterator::is_index_input(synapse_index)){ /* If @Partial_solution input is from the network input */
+      const uint32 network_input_index = Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_index);
+      const uint32 first_lane = network_input_index * batch_size;
+      if(checked_access && (input_data.size() < (first_lane + batch_size)))
+        throw "Partial solution input index is out of bounds of the network input!";
+      if(transformed){ /* Every sample of the input is transformed the same way */
+        const Input_transform& transform = input_transforms->Get(network_input_index);
+        collected_lanes = std::transform(
+          input_data.begin() + first_lane, input_data.begin() + first_lane + batch_size, collected_lanes,
+          [&transform](sdouble32 input){ return Input_transformer::get_value(transform, input); }
+        );
+      }else collected_lanes = std::copy_n(input_data.begin() + first_lane, batch_size, collected_lanes);
+    }else{  /* If @Partial_solution input is from the previous row */
+      const uint32 first_lane = synapse_index * batch_size;
+      if(checked_access && (neuron_data.size() < (first_lane + batch_size)))
+        throw "Partial solution input index is out of bounds of the Neuron data!";
+      collected_lanes = std::copy_n(neuron_data.begin() + first_lane, batch_size, collected_lanes);
+    }
+  }, 0, detail.get().input_data_size());
+}
+
+void Partial_solution_solver::prepare_batch(uint32 batch_size){
+  if(batch_size != batch_size_in_memory){ /* Lanes of a different batch are different samples */
+    batch_neuron_memory = vector<sdouble32>(number_of_neurons_with_memory * batch_size);
+    batch_size_in_memory = batch_size;
+  }
+}
+
+void Partial_solution_solver::solve_batch(const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 batch_size){
+  solve_batch(collected_input, neuron_output_buffer, batch_size, 0, detail.get().internal_neuron_number());
+}
+
+void Partial_solution_solver::solve_batch(
+  const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 batch_size,
+  uint32 first_neuron, uint32 end_neuron, bool previous_wavefronts_solved
+){
+  prepare_batch(batch_size);
+  if(checked){
+    if(
+      (collected_input.size() < (input_size * batch_size))
+      ||(neuron_output_buffer.size() < (detail.get().internal_neuron_number() * batch_size))
+    )throw "Buffer is too small for the Partial solution!";
+    if(!is_neuron_range_valid(first_neuron, end_neuron, previous_wavefronts_solved)) throw "Invalid Neuron range for the Partial solution!";
+    with_weight_table(detail.get(), weight_data, [&](const auto& weights){
+      solve_batch_internal<true>(weights, collected_input, neuron_output_buffer, batch_size, first_neuron, end_neuron);
+    });
+  }else{
+    with_weight_table(detail.get(), weight_data, [&](const auto& weights){
+      solve_batch_internal<false>(weights, collected_input, neuron_output_buffer, batch_size, first_neuron, end_neuron);
+    });
+  }
+}
 
-        /*!Note: It is possible, in case of an incorrect configuration that the indexes and synapses
-         * don't match. It is possible to increase the @weight_synapse_index above @detail.get().weight_synapse_number(neuron_iterator)
-         * but that isn't chekced here, mainly for performance reasons.
-         **/
+template<bool checked_access, uint32 block_size, typename Weight_table>
+void Partial_solution_solver::sum_neuron_input_lanes(
+  const Weight_table& weights, const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 batch_size,
+  uint32 first_neuron
+) const{
+  const Partial_solution& partial = detail.get();
+  sdouble32* neuron_lanes[block_size];
+  uint32 weight_synapse_index[block_size]; /* Which synapse is being processed inside every Neuron of the block */
+  const Synapse_interval* weight_synapse[block_size]; /* The synapse under @weight_synapse_index, read from the @Partial_solution once per synapse */
+  uint32 weight_index[block_size];
+  for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator){
+    neuron_lanes[block_iterator] = neuron_output_buffer.data() + ((first_neuron + block_iterator) * batch_size);
+    std::fill_n(neuron_lanes[block_iterator], batch_size, 0.0);
+    weight_synapse_index[block_iterator] = neuron_starts[first_neuron + block_iterator].weight_synapse;
+    weight_synapse[block_iterator] = first_weight_synapse(first_neuron + block_iterator);
+    weight_index[block_iterator] = 0;
+  }
+  if(0 < index_synapse_numbers.get().Get(first_neuron)){
+    packed_inside_indices.iterate_inline([&](int synapse_index){
+      const sdouble32* input_lanes;
+      if(Synapse_iterator::is_index_input(synapse_index)){ /* Neuron gets its input from the partialsolution input */
+        if(checked_access && (input_size <= Synapse_iterator::input_index_from_synapse_index(synapse_index)))
+          throw "Neuron input index is out of bounds of the Partial solution input!";
+        input_lanes = collected_input.data() + (Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_index) * batch_size);
+      }else{ /* Neuron gets its input internaly */
+        if(checked_access && (static_cast<int>(first_neuron) <= synapse_index))
+          throw "Neuron takes its input from itself or a Neuron after it inside the Partial solution!";
+        input_lanes = neuron_output_buffer.data() + (synapse_index * batch_size);
       }
-    },index_synapse_iterator_start, detail.get().index_synapse_number(neuron_iterator));
-    index_synapse_iterator_start += detail.get().index_synapse_number(neuron_iterator);
 
-    /* Add bias */
-    new_neuron_data += detail.get().weight_table(detail.get().bias_index(neuron_iterator));
+      sdouble32 weight[block_size];
+      for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator){
+        const uint32 neuron_index = first_neuron + block_iterator;
+        if(checked_access && (
+          (weight_synapse_index[block_iterator] >= (neuron_starts[neuron_index].weight_synapse + partial.weight_synapse_number(neuron_index)))
+          ||(weights.size() <= static_cast<int>(weight_synapse[block_iterator]->starts() + weight_index[block_iterator]))
+        ))throw "Neuron weight index is out of bounds!";
+        weight[block_iterator] = weights[weight_synapse[block_iterator]->starts() + weight_index[block_iterator]];
 
-    /* Apply transfer function */
-    new_neuron_data = Transfer_function::get_value(
-      detail.get().neuron_transfer_functions(neuron_iterator), new_neuron_data
-    );
+        ++weight_index[block_iterator]; /* Step the Weight index forwards */
+        if(weight_index[block_iterator] >= weight_synapse[block_iterator]->interval_size()){
+          weight_index[block_iterator] = 0; /* In case the next weight would ascend above the current patition, go to next one */
+          ++weight_synapse_index[block_iterator];
+          weight_synapse[block_iterator] = next_weight_synapse(weight_synapse_index[block_iterator], weight_synapse[block_iterator]);
+        }
+      }
+      for(uint32 lane_iterator = 0; lane_iterator < batch_size; ++lane_iterator){ /* Every lane of the input is read once for the block */
+        const sdouble32 input = input_lanes[lane_iterator];
+        for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator)
+          neuron_lanes[block_iterator][lane_iterator] += input * weight[block_iterator];
+      }
+    },neuron_starts[first_neuron].packed_index_synapse, index_synapse_numbers.get().Get(first_neuron));
+  }
+  for(uint32 block_iterator = 0; checked_access && (block_iterator < block_size); ++block_iterator){
+    const uint32 neuron_index = first_neuron + block_iterator;
+    if(
+      (0 != weight_index[block_iterator])
+      ||(weight_synapse_index[block_iterator] != (neuron_starts[neuron_index].weight_synapse + partial.weight_synapse_number(neuron_index)))
+    )throw "Number of Neuron weights don't match the number of Neuron inputs!";
+  }
+}
 
-    /* Apply memory filter */
-    neuron_output[neuron_iterator] = Spike_function::get_value(
-      detail.get().weight_table(detail.get().memory_filter_index(neuron_iterator)),
-      new_neuron_data,
-      neuron_output[neuron_iterator]
-    );
+template<bool checked_access, typename Weight_table>
+void Partial_solution_solver::solve_batch_internal(
+  const Weight_table& weights,
+  const vector<sdouble32>& collected_input, vector<sdouble32>& neuron_output_buffer, uint32 batch_size,
+  uint32 first_neuron, uint32 end_neuron
+){
+  const Partial_solution& partial = detail.get();
+  uint32 neuron_iterator = first_neuron;
+  while(neuron_iterator < end_neuron){
+    const uint32 block_size = get_neuron_block(neuron_iterator, end_neuron);
+    if(max_neuron_block == block_size)
+      sum_neuron_input_lanes<checked_access, max_neuron_block>(weights, collected_input, neuron_output_buffer, batch_size, neuron_iterator);
+    else if((max_neuron_block / 2) == block_size)
+      sum_neuron_input_lanes<checked_access, (max_neuron_block / 2)>(weights, collected_input, neuron_output_buffer, batch_size, neuron_iterator);
+    else sum_neuron_input_lanes<checked_access, 1>(weights, collected_input, neuron_output_buffer, batch_size, neuron_iterator);
+
+    for(uint32 block_iterator = 0; block_iterator < block_size; ++block_iterator, ++neuron_iterator){
+      sdouble32* neuron_lanes = neuron_output_buffer.data() + (neuron_iterator * batch_size);
+
+      /* Add bias and apply transfer function */
+      if(checked_access && (weights.size() <= partial.bias_index(neuron_iterator)))
+        throw "Neuron bias index is out of bounds!";
+      const sdouble32 bias = weights[partial.bias_index(neuron_iterator)];
+      const transfer_functions transfer_function = partial.neuron_transfer_functions(neuron_iterator);
+      for(uint32 lane_iterator = 0; lane_iterator < batch_size; ++lane_iterator)
+        neuron_lanes[lane_iterator] = Transfer_function::get_value(transfer_function, neuron_lanes[lane_iterator] + bias);
+
+      /* Apply memory filter; the lanes of a stateless Neuron already hold its data */
+      if(stateful_neurons[neuron_iterator]){
+        if(checked_access && (weights.size() <= partial.memory_filter_index(neuron_iterator)))
+          throw "Neuron memory filter index is out of bounds!";
+        const sdouble32 memory_filter = weights[partial.memory_filter_index(neuron_iterator)];
+        sdouble32* memory_lanes = batch_neuron_memory.data() + (neuron_starts[neuron_iterator].memory_index * batch_size);
+        for(uint32 lane_iterator = 0; lane_iterator < batch_size; ++lane_iterator){
+          memory_lanes[lane_iterator] = Spike_function::get_value(memory_filter, neuron_lanes[lane_iterator], memory_lanes[lane_iterator]);
+          neuron_lanes[lane_iterator] = memory_lanes[lane_iterator];
+        }
+      }
+    }
   } /* Go through the neurons */
-  return neuron_output;
 }
 
-uint32 Partial_solution_solver::get_input_size(void) const{
-  return collected_input_data.size();
-}
+bool Partial_solution_solver::is_valid(void) const{
+  if(nullptr == inside_indices) return true; /* Shared inputs are verified while constructing, before their synapses are released */
+  const Partial_solution& partial = detail.get();
+  int weight_table_size = 0;
+  with_weight_table(partial, nullptr, [&weight_table_size](const auto& weights){
+    weight_table_size = weights.size();
+  });
+  auto is_weight_table_index = [weight_table_size](sdouble32 index){
+    return ((0.0 <= index)&&(std::floor(index) == index)&&(index < weight_table_size));
+  };
 
-bool Partial_solution_solver::is_valid(void){
   if(
-    (0u < detail.get().internal_neuron_number())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().index_synapse_number_size())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().weight_synapse_number_size())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().actual_index_size())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().neuron_transfer_functions_size())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().memory_filter_index_size())
-    &&(static_cast<int>(detail.get().internal_neuron_number()) == detail.get().bias_index_size())
+    (weight_storages_IsValid(partial.weight_storage()))
+    &&((WEIGHT_STORAGE_DOUBLE == partial.weight_storage())? /* Only the table of the format is used */
+      (partial.half_weight_table().empty())
+      :((0 == partial.weight_table_size())&&(0 == (partial.half_weight_table().size() % sizeof(uint16))))
+    )
+    &&(0u < partial.internal_neuron_number())
+    &&(static_cast<int>(partial.internal_neuron_number()) == index_synapse_numbers.get().size())
+    &&(static_cast<int>(partial.internal_neuron_number()) == partial.weight_synapse_number_size())
+    &&(static_cast<int>(partial.internal_neuron_number()) == partial.actual_index_size())
+    &&(static_cast<int>(partial.internal_neuron_number()) == partial.neuron_transfer_functions_size())
+    &&(static_cast<int>(partial.internal_neuron_number()) == partial.memory_filter_index_size())
+    &&(static_cast<int>(partial.internal_neuron_number()) == partial.bias_index_size())
   ){
-    int weight_synapse_number = 0;
-    int index_synapse_number = 0;
-
-    for(uint16 neuron_iterator = 0u; neuron_iterator < detail.get().internal_neuron_number(); ++neuron_iterator){
-      weight_synapse_number += detail.get().weight_synapse_number(neuron_iterator); /* Calculate how many inputs the neuron shall have altogether */
-      index_synapse_number += detail.get().index_synapse_number(neuron_iterator); /* Calculate how many inputs the neuron shall have altogether */
+    if((0 < partial.neuron_memoryless_size())&&(static_cast<int>(partial.internal_neuron_number()) != partial.neuron_memoryless_size()))
+      return false;
+    if(!shared_input){ /* Only a shared input can provide the data of the Neurons from the previous run */
+      for(const Synapse_interval& input_synapse : partial.input_data())
+        if(input_synapse.delayed()) return false;
     }
 
-    if((0 < index_synapse_number)&&(0 < weight_synapse_number)){
-      /* Check if the inputs for every Neuron are before its index.
+    int index_synapse_iterator_start = 0;
+    int weight_synapse_iterator_start = 0;
+    uint32 count_of_input_indexes;
+    uint32 count_of_input_weights;
+    for(uint32 neuron_iterator = 0; neuron_iterator < partial.internal_neuron_number(); ++neuron_iterator){
+      if(
+        (!transfer_functions_IsValid(partial.neuron_transfer_functions(neuron_iterator)))
+        ||(TRANSFER_FUNCTION_UNKNOWN == partial.neuron_transfer_functions(neuron_iterator))
+        ||(!is_weight_table_index(partial.bias_index(neuron_iterator)))
+        ||(!is_weight_table_index(partial.memory_filter_index(neuron_iterator)))
+        ||(inside_indices->size() < static_cast<int>(index_synapse_iterator_start + index_synapse_numbers.get().Get(neuron_iterator)))
+        ||(partial.weight_indices_size() < static_cast<int>(weight_synapse_iterator_start + partial.weight_synapse_number(neuron_iterator)))
+      )return false;
+
+      /* Check if the inputs for every Neuron are before its index, or inside the @Partial_solution input.
        * This will ensure that there are no unresolved dependencies are present at any Neuron
        **/
-      uint32 index_synapse_iterator_start = 0;
-      uint32 count_of_input_indexes = 0;
-      uint32 weight_synapse_iterator_start = 0;
-      uint32 count_of_input_weights = 0;
-      for(uint32 neuron_iterator = 0; neuron_iterator < detail.get().internal_neuron_number(); neuron_iterator++){
-        count_of_input_indexes = 0;
-        count_of_input_weights = 0;
-        for(uint32 internal_iterator = 0; internal_iterator < detail.get().index_synapse_number(neuron_iterator); ++internal_iterator){
-          count_of_input_indexes += detail.get().inside_indices(index_synapse_iterator_start + internal_iterator).interval_size();
-          if( /* If a synapse input in a Neuron points after the neurons index */
-            (detail.get().inside_indices(index_synapse_iterator_start + internal_iterator).starts()
-             + detail.get().inside_indices(index_synapse_iterator_start + internal_iterator).interval_size() ) >= neuron_iterator
-          ){ /* Self-recurrence is simulated by adding the current data of a neuron as an input into the solution detail */
-            return false;
-          }
-
-          /* Check if the number of weights match the number of input indexes for every Neuron */
-          for(uint32 internal_iterator = 0; internal_iterator < detail.get().weight_synapse_number(neuron_iterator); ++internal_iterator){
-            count_of_input_weights +=  detail.get().weight_indices(weight_synapse_iterator_start + internal_iterator).interval_size();
-          }
-          weight_synapse_iterator_start += detail.get().weight_synapse_number(neuron_iterator);
-          index_synapse_iterator_start += detail.get().index_synapse_number(neuron_iterator);
-
-          if(count_of_input_indexes == count_of_input_weights){
-            return false;
-          }
+      count_of_input_indexes = 0;
+      for(uint32 synapse_iterator = 0; synapse_iterator < index_synapse_numbers.get().Get(neuron_iterator); ++synapse_iterator){
+        const Synapse_interval& index_synapse = inside_indices->Get(index_synapse_iterator_start + synapse_iterator);
+        if(0 == index_synapse.interval_size()) continue;
+        if(Synapse_iterator::is_index_input(index_synapse.starts())){
+          if(input_size < (Synapse_iterator::input_index_from_synapse_index(index_synapse.starts()) + index_synapse.interval_size()))
+            return false; /* The synapse points out of the @Partial_solution input */
+        }else if(neuron_iterator < (index_synapse.starts() + index_synapse.interval_size())){
+          return false; /* Self-recurrence is simulated by adding the current data of a neuron as an input into the solution detail */
         }
+        count_of_input_indexes += index_synapse.interval_size();
+      }
+
+      /* Check if the number of weights match the number of input indexes for every Neuron */
+      count_of_input_weights = 0;
+      for(uint32 synapse_iterator = 0; synapse_iterator < partial.weight_synapse_number(neuron_iterator); ++synapse_iterator){
+        const Synapse_interval& weight_synapse = partial.weight_indices(weight_synapse_iterator_start + synapse_iterator);
+        if(
+          (0 == weight_synapse.interval_size())||(0 > weight_synapse.starts())
+          ||(weight_table_size < static_cast<int>(weight_synapse.starts() + weight_synapse.interval_size()))
+        )return false; /* Weight synapses shall be non-empty, and shall point inside the weight table */
+        count_of_input_weights += weight_synapse.interval_size();
       }
-    }else return false;
+      if(count_of_input_indexes != count_of_input_weights) return false;
+
+      index_synapse_iterator_start += index_synapse_numbers.get().Get(neuron_iterator);
+      weight_synapse_iterator_start += partial.weight_synapse_number(neuron_iterator);
+    }
 
     return(
-      (index_synapse_number == detail.get().inside_indices_size())
-      &&(weight_synapse_number == detail.get().weight_indices_size())
+      (index_synapse_iterator_start == inside_indices->size())
+      &&(weight_synapse_iterator_start == partial.weight_indices_size())
     );
   }else return false;
 }
@@ -0,0 +1,169 @@
+#include "services/population_evaluator.h"
+
+#include <chrono>
+#include <future>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sparse_net_library{
+
+namespace{
+
+/* The batches submitted ahead of the one being waited for; enough to keep the workers busy between the batches */
+const uint32 batches_in_flight = 3;
+
+/**
+ * @brief      Gets the number of standard deviations a normally distributed value stays below
+ *             with the given probability; infinite for a probability of 1
+ */
+sdouble32 quantile_of_normal_distribution(sdouble32 probability){
+  if(1.0 <= probability) return std::numeric_limits<sdouble32>::infinity();
+  sdouble32 lower = 0.0;
+  sdouble32 upper = 40.0;
+  for(uint32 step_iterator = 0; step_iterator < 100; ++step_iterator){ /* bisection on the cumulative distribution */
+    const sdouble32 middle = (lower + upper) / 2.0;
+    if((0.5 * std::erfc(-middle / std::sqrt(2.0))) < probability) lower = middle;
+      else upper = middle;
+  }
+  return lower;
+}
+
+} /* namespace */
+
+Population_evaluator::Population_evaluator(
+  const vector<const SparseNet*>& nets_, Solution_builder solution_builder, Service_context context
+): nets(nets_)
+{
+  if(std::any_of(nets.begin(), nets.end(), [](const SparseNet* net){ return (nullptr == net); }))
+    throw "A candidate without a net!";
+  workers = std::make_unique<Worker_pool>(context.get_max_solve_threads(), context.get_numa_topology());
+  solution_builder.arena_ptr(nullptr);
+  solutions.resize(nets.size());
+  workers->run_in_chunks(nets.size(), [&](uint16 chunk_index, uint32 chunk_start, uint32 chunk_end){
+    Solution_builder builder = solution_builder; /* Every chunk builds with its own copy of the builder */
+    for(uint32 candidate_index = chunk_start; candidate_index < chunk_end; ++candidate_index)
+      solutions[candidate_index].reset(builder.build(*nets[candidate_index]));
+  });
+
+  /* The solvers construct their partial solvers with the shared workers, so they are constructed one after another */
+  context.set_worker_pool(workers.get());
+  solvers.reserve(nets.size());
+  for(const unique_ptr<Solution>& solution : solutions)
+    solvers.push_back(std::make_unique<Solution_solver>(*solution, context));
+}
+
+Population_evaluator::Evaluation Population_evaluator::evaluate(
+  const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size
+){
+  return solve_samples(input_samples, label_samples, batch_size, std::numeric_limits<sdouble32>::infinity(), 1.0);
+}
+
+Population_evaluator::Evaluation Population_evaluator::race(
+  const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size,
+  sdouble32 cost_bound, sdouble32 confidence
+){
+  if(std::isnan(cost_bound)) throw "Invalid cost bound!";
+  return solve_samples(input_samples, label_samples, batch_size, cost_bound, confidence);
+}
+
+Population_evaluator::Evaluation Population_evaluator::solve_samples(
+  const vector<vector<sdouble32>>& input_samples, const vector<vector<sdouble32>>& label_samples, uint32 batch_size,
+  sdouble32 cost_bound, sdouble32 confidence
+){
+  if(0 == batch_size) throw "A batch of 0 samples!";
+  if(input_samples.size() != label_samples.size()) throw "Incompatible Feature and Label sizes!";
+  if(!((0.5 <= confidence)&&(confidence <= 1.0))) throw "Invalid confidence!";
+  for(uint32 candidate_index = 0; candidate_index < solutions.size(); ++candidate_index){
+    if(COST_FUNCTION_QUADRATIC != nets[candidate_index]->cost_function()) throw "Unknown cost function requested from evaluator!";
+    for(const vector<sdouble32>& label : label_samples)
+      if(label.size() != solutions[candidate_index]->output_neuron_number()) throw "Incompatible Feature and Label sizes!";
+  }
+  const uint32 input_size = (0 < input_samples.size())?(input_samples[0].size()):(0u);
+  if(std::any_of(input_samples.begin(), input_samples.end(), [input_size](const vector<sdouble32>& input){
+    return (input.size() != input_size);
+  }))throw "Input samples of different sizes!";
+
+  const uint32 number_of_samples = input_samples.size();
+  const uint32 number_of_batches = (number_of_samples + batch_size - 1) / batch_size;
+  const sdouble32 deviations = quantile_of_normal_distribution( /* A candidate is checked after every batch */
+    1.0 - (1.0 - confidence) / std::max(1u, number_of_batches)
+  );
+  Evaluation evaluation;
+  evaluation.errors = vector<sdouble32>(solutions.size(), 0.0);
+  evaluation.evaluated_samples = vector<uint32>(solutions.size(), 0);
+  vector<sdouble32> sample_cost_squares(solutions.size(), 0.0); /* For the variance of the cost of a sample */
+  vector<bool> racing(solutions.size(), true);
+  uint64 solved_candidate_samples = 0;
+  vector<vector<std::future<vector<sdouble32>>>> batch_results(number_of_batches);
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  auto submit = [&](uint32 batch_index){ /* Pack the samples of the batch once, and give it to every candidate still racing */
+    const uint32 first_sample = batch_index * batch_size;
+    const uint32 lanes = std::min(batch_size, number_of_samples - first_sample);
+    std::shared_ptr<vector<sdouble32>> batch = std::make_shared<vector<sdouble32>>(input_size * lanes);
+    for(uint32 lane_iterator = 0; lane_iterator < lanes; ++lane_iterator)
+      for(uint32 input_iterator = 0; input_iterator < input_size; ++input_iterator)
+        (*batch)[input_iterator * lanes + lane_iterator] = input_samples[first_sample + lane_iterator][input_iterator];
+    batch_results[batch_index].resize(solvers.size());
+    for(uint32 candidate_index = 0; candidate_index < solvers.size(); ++candidate_index){
+      if(racing[candidate_index]){
+        batch_results[batch_index][candidate_index] = solvers[candidate_index]->submit_batch(
+          std::shared_ptr<const vector<sdouble32>>(batch), lanes
+        );
+      }
+    }
+  };
+  for(uint32 batch_index = 0; batch_index < std::min(batches_in_flight, number_of_batches); ++batch_index)
+    submit(batch_index);
+  for(uint32 batch_index = 0; batch_index < number_of_batches; ++batch_index){
+    const uint32 first_sample = batch_index * batch_size;
+    const uint32 lanes = std::min(batch_size, number_of_samples - first_sample);
+    for(uint32 candidate_index = 0; candidate_index < solvers.size(); ++candidate_index){
+      if(!racing[candidate_index]) continue; /* The batches already submitted to a stopped candidate are not counted */
+      const vector<sdouble32> outputs = batch_results[batch_index][candidate_index].get();
+      for(uint32 lane_iterator = 0; lane_iterator < lanes; ++lane_iterator){
+        const vector<sdouble32>& label = label_samples[first_sample + lane_iterator];
+        sdouble32 sample_cost = 0.0;
+        for(uint32 output_iterator = 0; output_iterator < label.size(); ++output_iterator){
+          const sdouble32 distance = outputs[output_iterator * lanes + lane_iterator] - label[output_iterator];
+          sample_cost += 0.5 * distance * distance;
+        }
+        evaluation.errors[candidate_index] += sample_cost;
+        sample_cost_squares[candidate_index] += sample_cost * sample_cost;
+      }
+      evaluation.evaluated_samples[candidate_index] += lanes;
+      solved_candidate_samples += lanes;
+      racing[candidate_index] = ( /* The candidate is stopped once it surely can't beat the bound */
+        cost_bound >= get_lowest_expected_error(
+          evaluation.errors[candidate_index], sample_cost_squares[candidate_index],
+          evaluation.evaluated_samples[candidate_index], number_of_samples, deviations
+        )
+      );
+    }
+    batch_results[batch_index].clear();
+    if((batch_index + batches_in_flight) < number_of_batches)
+      submit(batch_index + batches_in_flight);
+  }
+  evaluation.seconds = std::chrono::duration<sdouble32>(std::chrono::steady_clock::now() - start).count();
+  evaluation.candidate_samples_per_second = (0.0 < evaluation.seconds)?(solved_candidate_samples / evaluation.seconds):(0.0);
+  for(uint32 candidate_index = 0; candidate_index < solutions.size(); ++candidate_index){ /* ( 0.5*(expected-calculated)^2 )/dataset_size */
+    if(0 < evaluation.evaluated_samples[candidate_index])
+      evaluation.errors[candidate_index] /= evaluation.evaluated_samples[candidate_index];
+  }
+  return evaluation;
+}
+
+sdouble32 Population_evaluator::get_lowest_expected_error(
+  sdouble32 cost_sum, sdouble32 cost_square_sum, uint32 evaluated_samples, uint32 number_of_samples, sdouble32 deviations
+){
+  if(0 == number_of_samples) return 0.0;
+  sdouble32 lowest_sample_cost = 0.0; /* The cost of a sample is never negative */
+  if((1 < evaluated_samples)&&(std::isfinite(deviations))){ /* The lower confidence bound of the mean cost of a sample */
+    const sdouble32 mean = cost_sum / evaluated_samples;
+    const sdouble32 variance = std::max(0.0, (cost_square_sum - evaluated_samples * mean * mean) / (evaluated_samples - 1));
+    lowest_sample_cost = std::max(0.0, mean - deviations * std::sqrt(variance / evaluated_samples));
+  }
+  return (cost_sum + (number_of_samples - evaluated_samples) * lowest_sample_cost) / number_of_samples;
+}
+
+} /* namespace sparse_net_library */
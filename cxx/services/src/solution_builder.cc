@@ -1,10 +1,32 @@
 #include "services/solution_builder.h"
 
 #include "models/neuron_info.h"
+#include "models/half_float.h"
 #include "services/partial_solution_builder.h"
 
 namespace sparse_net_library{
 
+namespace{
+
+/**
+ * @brief      Verifies the size calculated for a built @Partial_solution by walking through the message,
+ *             only in debug builds, as it takes as long as building the @Partial_solution did
+ */
+void verify_partial_size(const Partial_solution& partial){
+#ifndef NDEBUG
+  const uint64 space_used = partial.SpaceUsedLong();
+  const uint64 calculated_size = Partial_solution_builder::get_partial_size_bytes(partial);
+  if(
+    ((space_used + Partial_solution_builder::size_tolerance_bytes) < calculated_size)
+    ||((calculated_size + Partial_solution_builder::size_tolerance_bytes) < space_used)
+  )throw "Partial solution size is miscalculated!";
+#else
+  (void)partial;
+#endif
+}
+
+} /* namespace */
+
 Solution* Solution_builder::build(const SparseNet& net ){
 
   using std::ref;
@@ -23,18 +45,21 @@ Solution* Solution_builder::build(const SparseNet& net ){
   uint32 partial_output_synapse_count = 0;
   uint32 latest_placed_neuron_index = net.neuron_array_size();
   bool strict_mode = false;
+  auto current_partial_megabytes = [&current_partial](){ /* The size doesn't need walking through the whole message */
+    return (Partial_solution_builder::get_partial_size_bytes(*current_partial) /* Bytes */ / 1024.0 /* KB *// 1024.0 /* MB */);
+  };
 
   if(0 == net.output_neuron_number()) throw "Can't build a solution with 0 output Neurons!";
   while(!net_iterator.finished()){ /* Until the whole output layer is processed */
     net_iterator.collect_subset(arg_max_solve_threads,arg_device_max_megabytes, strict_mode); /* Collect solvable neuron indices */
     placed_neurons_in_partial = net_iterator.get_subset_size();
     while (
-      ((current_partial->SpaceUsedLong() /* Bytes */ / 1024.0 /* KB *// 1024.0 /* MB */) <= arg_device_max_megabytes)
+      (current_partial_megabytes() <= arg_device_max_megabytes)
       &&(0 < placed_neurons_in_partial)
     ){
       placed_neurons_in_partial = 0;
       while( /* Put all collected Neurons into the current @Partial_solution */
-        ((current_partial->SpaceUsedLong() /* Bytes */ / 1024.0 /* KB *// 1024.0 /* MB */) <= arg_device_max_megabytes)
+        (current_partial_megabytes() <= arg_device_max_megabytes)
         &&(placed_neurons_in_row < net_iterator.get_subset_size())
       ){ 
         neuron_index = net_iterator[placed_neurons_in_row];
@@ -56,7 +81,7 @@ Solution* Solution_builder::build(const SparseNet& net ){
       }
     } /* Loop for placing the Neurons from the subset into the Partial Solutions */
     if( /* If no Neurons could be placed inside the partial_matrix, a new row is needed */
-      (current_partial->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */) < arg_device_max_megabytes
+      (current_partial_megabytes() < arg_device_max_megabytes)
       &&(0 == placed_neurons_in_partial)
     ){
       if(0 == partial_matrix.back().back()->internal_neuron_number()){
@@ -73,12 +98,12 @@ Solution* Solution_builder::build(const SparseNet& net ){
       neurons_in_row.clear();
       placed_neurons_in_row = 0;
       ++row_iterator;
-    }else if((current_partial->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */) >= arg_device_max_megabytes){
+    }else if(current_partial_megabytes() >= arg_device_max_megabytes){
       /* Put a new Partial_solution into the current row if the memory limit is reached */
       current_partial = google::protobuf::Arena::CreateMessage<Partial_solution>(arg_arena_ptr);
       partial_matrix[row_iterator].push_back(current_partial); /* In case the @Partial_solution reached the size limit, push in a new one */
       partial_builder = Partial_solution_builder(net, *current_partial);
-      net_iterator.reset_remaining_subset();
+      net_iterator.reset_remaining_subset(placed_neurons_in_row); /* Placed Neurons stay reserved until the row is finished */
       strict_mode = true;
     }
   } /* while(!net_iterator.finished()) */
@@ -94,10 +119,14 @@ Solution* Solution_builder::build(const SparseNet& net ){
 
   solution->set_output_neuron_number(net.output_neuron_number());
   solution->set_neuron_number(net.neuron_array_size());
+  *solution->mutable_input_transforms() = net.input_transforms();
   for(vector<Partial_solution*> row : partial_matrix){
     solution->add_cols(row.size());
     for(Partial_solution* cell : row){
-      *solution->add_partial_solutions() = *cell;
+      verify_partial_size(*cell);
+      Partial_solution* partial = solution->add_partial_solutions();
+      *partial = *cell;
+      Half_float::store_weight_table(*partial, arg_weight_storage);
     }
   } /* Build the @Solution from the @Partial_Solution matrix */
 
@@ -1,87 +1,612 @@
 #include "services/solution_solver.h"
 #include "services/synapse_iterator.h"
+#include "services/solution_structure_verifier.h"
+#include "models/input_transformer.h"
 
-#include <thread>
+#include <algorithm>
+#include <iterator>
 
 namespace sparse_net_library{
 
-using std::swap_ranges;
+const uint32 Solution_solver::staged_slot_none;
+
+namespace{
+
+/* Smaller ranges of Neurons are not worth solving by separate workers */
+const uint32 min_neurons_in_range = 16;
+
+} /* namespace */
 
 Solution_solver::Solution_solver(
   const Solution& to_solve, Service_context context
 ): solution(to_solve){
-  number_of_threads = context.get_max_solve_threads();
-  partial_solvers = vector<vector<Partial_solution_solver>>(solution.cols_size());
-  partial_solver_output_maps = vector<vector<Synapse_iterator>>(solution.cols_size());
-  neuron_data = vector<sdouble32>(solution.neuron_number());
+  if(!is_valid()) throw "Invalid Solution!";
+  workers = context.get_worker_pool();
+  number_of_threads = (nullptr != workers)?(workers->get_number_of_workers()):(context.get_max_solve_threads());
+  checked = context.get_checked_solve();
+  numa_topology = context.get_numa_topology();
+  if(nullptr == workers){
+    owned_workers = std::make_unique<Worker_pool>(number_of_threads, numa_topology);
+    workers = owned_workers.get();
+  }
+  const bool multiple_nodes = ((nullptr != numa_topology)&&(1 < workers->get_number_of_nodes()));
+  neuron_data_allocator = Huge_page_allocator<sdouble32>(context.get_huge_page_storage(), multiple_nodes);
+  uint32 slot_alignment = 1;
+  if(multiple_nodes) slot_alignment = page_bytes / sizeof(sdouble32); /* Partials on different nodes write into separate pages */
+    else if(context.get_cache_aligned_partials() && (1 < number_of_threads))
+      slot_alignment = cache_line_bytes / sizeof(sdouble32); /* Parallel partials write into separate cache lines */
+  memory_plan = std::make_unique<Memory_planner>(solution, slot_alignment);
+  has_past_inputs = (0 < memory_plan->get_past_slots().size());
+  past_data.assign(Synapse_iterator(memory_plan->get_past_slots()).size(), 0.0);
+  row_first_partial = vector<uint32>(solution.cols_size() + 1, 0);
+  vector<uint32> row_input_size(solution.cols_size(), 0);
   for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
-    partial_solvers[row_iterator] = vector<Partial_solution_solver>(
-      solution.cols(row_iterator), Partial_solution_solver(get_partial(0,0,solution))
-    );
-    for(uint32 column_index = 0; column_index < solution.cols(row_iterator); ++column_index){
-      partial_solvers[row_iterator][column_index] = Partial_solution_solver(
-        get_partial(row_iterator,column_index,solution)
-      ); /* Initialize a solver for this partial solution element */
-      partial_solver_output_maps[row_iterator].push_back(Synapse_iterator(
-        get_partial(row_iterator,column_index,solution).output_data()
-      )); /* Initialize a solver and output map for this partial @Partial_solution element */
+    row_first_partial[row_iterator + 1] = row_first_partial[row_iterator] + solution.cols(row_iterator);
+    Synapse_iterator(memory_plan->get_row_inputs(row_iterator)).skim_inline([&](int synapse_starts, unsigned int synapse_size){
+      row_input_size[row_iterator] += synapse_size;
+      if(Synapse_iterator::is_index_input(synapse_starts))
+        required_input_size = std::max(required_input_size, Synapse_iterator::input_index_from_synapse_index(synapse_starts) + synapse_size);
+    });
+  }
+  if(
+    (0 < solution.input_transforms_size())&&(
+      (static_cast<uint32>(solution.input_transforms_size()) < required_input_size)
+      ||(!std::all_of(solution.input_transforms().begin(), solution.input_transforms().end(), Input_transformer::is_valid))
+    )
+  )throw "Invalid input transforms!";
+  partial_jobs_done = vector<uint64>(solution.partial_solutions_size(), 0);
+  assign_nodes();
+
+  /* The partial solvers verify their @Partial_solution while constructed, so they are constructed by the workers in parallel */
+  vector<vector<Partial_solution_solver>> chunk_solvers(workers->get_number_of_workers());
+  vector<uint32> chunk_max_neuron_number(workers->get_number_of_workers(), 0);
+  workers->run_in_chunks(solution.partial_solutions_size(), [&](uint16 chunk_index, uint32 chunk_start, uint32 chunk_end){
+    vector<Partial_solution_solver>& solvers = chunk_solvers[chunk_index];
+    solvers.reserve(chunk_end - chunk_start);
+    uint32 row_iterator = std::upper_bound(row_first_partial.begin(), row_first_partial.end(), chunk_start) - row_first_partial.begin() - 1;
+    for(uint32 partial_index = chunk_start; partial_index < chunk_end; ++partial_index){
+      while(row_first_partial[row_iterator + 1] <= partial_index) ++row_iterator;
+      solvers.push_back(Partial_solution_solver(
+        solution.partial_solutions(partial_index), memory_plan->get_partial_inside_indices(partial_index),
+        memory_plan->get_partial_index_synapse_numbers(partial_index), row_input_size[row_iterator], checked
+      )); /* Initialize a solver for this partial solution element, reading its inputs from the row input */
+      chunk_max_neuron_number[chunk_index] = std::max(
+        chunk_max_neuron_number[chunk_index], solution.partial_solutions(partial_index).internal_neuron_number()
+      );
     }
-  } /* loop through every partial solution and initialize solvers and output maps for them */
+  });
+  partial_solvers.reserve(solution.partial_solutions_size());
+  for(vector<Partial_solution_solver>& solvers : chunk_solvers)
+    std::move(solvers.begin(), solvers.end(), std::back_inserter(partial_solvers));
+  memory_plan->release_partial_inside_indices(); /* The partial solvers read their packed copies */
+  partial_solver_output_maps.reserve(solution.partial_solutions_size());
+  for(int partial_index = 0; partial_index < solution.partial_solutions_size(); ++partial_index)
+    partial_solver_output_maps.push_back(Synapse_iterator(memory_plan->get_partial_outputs(partial_index)));
+  max_neuron_number = *std::max_element(chunk_max_neuron_number.begin(), chunk_max_neuron_number.end());
+  worker_neuron_outputs = vector<vector<sdouble32>>(workers->get_number_of_workers(), vector<sdouble32>(max_neuron_number));
+  divide_into_ranges();
+  if(multiple_nodes){
+    node_weight_tables.resize(solution.partial_solutions_size());
+    refresh_weights();
+  }
+}
+
+Solution_solver::Solution_solver(Solution_solver&& other) /* Only idle solvers are to be moved */
+: solution(other.solution)
+, memory_plan(std::move(other.memory_plan))
+, row_first_partial(std::move(other.row_first_partial))
+, partial_solvers(std::move(other.partial_solvers))
+, partial_solver_output_maps(std::move(other.partial_solver_output_maps))
+, worker_neuron_outputs(std::move(other.worker_neuron_outputs))
+, max_neuron_number(other.max_neuron_number)
+, worker_output_lanes(other.worker_output_lanes)
+, number_of_threads(other.number_of_threads)
+, required_input_size(other.required_input_size)
+, checked(other.checked)
+, neuron_data_allocator(other.neuron_data_allocator)
+, numa_topology(other.numa_topology)
+, partial_node(std::move(other.partial_node))
+, node_weight_tables(std::move(other.node_weight_tables))
+, partial_first_stage(std::move(other.partial_first_stage))
+, stage_first_range(std::move(other.stage_first_range))
+, partial_staged_slot(std::move(other.partial_staged_slot))
+, number_of_staged_slots(other.number_of_staged_slots)
+, neuron_ranges(std::move(other.neuron_ranges))
+, has_past_inputs(other.has_past_inputs)
+, past_data(std::move(other.past_data))
+, batch_past_data(std::move(other.batch_past_data))
+, batch_size_in_past(other.batch_size_in_past)
+, partial_tasks(std::move(other.partial_tasks))
+, free_partial_tasks(std::move(other.free_partial_tasks))
+, idle_jobs(std::move(other.idle_jobs))
+, jobs_submitted(other.jobs_submitted)
+, partial_jobs_done(std::move(other.partial_jobs_done))
+, owned_workers(std::move(other.owned_workers))
+, workers(other.workers)
+{ }
+
+Solution_solver::~Solution_solver(){
+  std::unique_lock<std::mutex> my_lock(scheduler_mutex);
+  jobs_finished.wait(my_lock,[this](){ /* With a shared @Worker_pool, the tasks of the solver might still be running */
+    return ((0 == jobs_in_flight.size())&&(0 == queued_tasks));
+  });
 }
 
 vector<sdouble32> Solution_solver::solve(vector<sdouble32> input){
+  vector<sdouble32> output;
+  solve(input, output);
+  return output;
+}
+
+void Solution_solver::solve(const vector<sdouble32>& input, vector<sdouble32>& output){
+  if(input.size() < required_input_size) throw "Input is too small for the Solution!";
+  solve_job(input, 0, output);
+}
+
+future<vector<sdouble32>> Solution_solver::submit(vector<sdouble32> input){
+  if(input.size() < required_input_size) throw "Input is too small for the Solution!";
+  return submit_job(std::move(input), nullptr, 0);
+}
+
+vector<sdouble32> Solution_solver::solve_batch(vector<sdouble32> inputs, uint32 batch_size){
+  vector<sdouble32> outputs;
+  solve_batch(inputs, batch_size, outputs);
+  return outputs;
+}
+
+void Solution_solver::solve_batch(const vector<sdouble32>& inputs, uint32 batch_size, vector<sdouble32>& outputs){
+  if(0 == batch_size) throw "A batch of 0 samples!";
+  if(inputs.size() < (required_input_size * batch_size)) throw "Input is too small for the Solution!";
+  solve_job(inputs, batch_size, outputs);
+}
+
+future<vector<sdouble32>> Solution_solver::submit_batch(vector<sdouble32> inputs, uint32 batch_size){
+  if(0 == batch_size) throw "A batch of 0 samples!";
+  if(inputs.size() < (required_input_size * batch_size)) throw "Input is too small for the Solution!";
+  return submit_job(std::move(inputs), nullptr, batch_size);
+}
+
+future<vector<sdouble32>> Solution_solver::submit_batch(shared_ptr<const vector<sdouble32>> inputs, uint32 batch_size){
+  if(0 == batch_size) throw "A batch of 0 samples!";
+  if((nullptr == inputs)||(inputs->size() < (required_input_size * batch_size))) throw "Input is too small for the Solution!";
+  return submit_job(vector<sdouble32>(), std::move(inputs), batch_size);
+}
 
-  using std::thread;
-  using std::ref;
-  using std::min;
+void Solution_solver::solve_job(const vector<sdouble32>& input, uint32 batch_size, vector<sdouble32>& output){
+  if(0 < solution.cols_size()){
+    output.resize(solution.output_neuron_number() * std::max(1u, batch_size));
+    std::exception_ptr error;
+    shared_ptr<Solve_job> job;
+    {
+      std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+      job = acquire_job(batch_size);
+    }
+    job->input = &input; /* The caller waits for the job, so its input and output live long enough */
+    job->output = &output;
+    if(!has_past_inputs) gather_row_input(*job, 0); /* Otherwise it is gathered once the previous job is finished */
+    {
+      std::unique_lock<std::mutex> my_lock(scheduler_mutex);
+      start_job(job);
+      jobs_finished.wait(my_lock,[&job](){ return job->finished; });
+      error = job->error;
+      job->error = nullptr;
+      idle_jobs.push_back(std::move(job));
+    }
+    if(error) std::rethrow_exception(error);
+  }else throw "A solution of 0 rows!";
+}
 
+future<vector<sdouble32>> Solution_solver::submit_job(
+  vector<sdouble32> input, shared_ptr<const vector<sdouble32>> shared_input, uint32 batch_size
+){
   if(0 < solution.cols_size()){
-    uint32 partial_solution_start;
-    vector<thread> solve_threads;
-    uint32 col_iterator;
+    shared_ptr<Solve_job> job;
+    {
+      std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+      job = acquire_job(batch_size);
+    }
+    if(nullptr != shared_input){ /* The job keeps the shared input alive until it is finished */
+      job->shared_input = std::move(shared_input);
+      job->input = job->shared_input.get();
+    }else{
+      job->owned_input = std::move(input);
+      job->input = &job->owned_input;
+    }
+    job->result = promise<vector<sdouble32>>();
+    future<vector<sdouble32>> result = job->result.get_future();
+    if(!has_past_inputs) gather_row_input(*job, 0); /* Otherwise it is gathered once the previous job is finished */
+    std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+    start_job(job);
+    return result;
+  }else throw "A solution of 0 rows!";
+}
 
-    for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
-      partial_solution_start = 0;
-      col_iterator = 0;
-      if(0 == solution.cols(row_iterator)) throw "A solution row of 0 columns!";
-      while(col_iterator < solution.cols(row_iterator)){
-        for(uint16 i = 0; i < number_of_threads; ++i){
-          if(col_iterator < solution.cols(row_iterator)){
-            solve_threads.push_back(thread(&Solution_solver::solve_a_partial,
-              this, ref(input), row_iterator, col_iterator, partial_solution_start
-            ));
-            partial_solution_start += get_partial(row_iterator,col_iterator,solution).internal_neuron_number();
-            ++col_iterator;
-          }else break;
+shared_ptr<Solution_solver::Solve_job> Solution_solver::acquire_job(uint32 batch_size){
+  shared_ptr<Solve_job> job;
+  if(0 < idle_jobs.size()){
+    job = std::move(idle_jobs.back());
+    idle_jobs.pop_back();
+  }else job = std::make_shared<Solve_job>(neuron_data_allocator);
+  job->batch_size = batch_size;
+  job->output = nullptr;
+  job->finished = false;
+  job->gathered_row = 0;
+  job->unsolved_partials_in_row.assign(solution.cols().begin(),solution.cols().end());
+  job->unsolved_ranges.resize(solution.partial_solutions_size());
+  job->partial_stages.resize(solution.partial_solutions_size());
+  job->staged_outputs.resize(number_of_staged_slots);
+  job->neuron_data.resize(memory_plan->get_neuron_data_size() * std::max(1u, batch_size));
+  if((nullptr != numa_topology)&&(job->placed_neuron_data != job->neuron_data.data())){
+    place_neuron_data(*job);
+    job->placed_neuron_data = job->neuron_data.data();
+  }
+  job->row_input.resize(memory_plan->get_max_row_input_size() * std::max(1u, batch_size));
+  if((worker_output_lanes < batch_size)&&(0 == queued_tasks)){ /* No worker uses its buffer, so every buffer is sized for the batch at once */
+    for(vector<sdouble32>& worker_neuron_output : worker_neuron_outputs)
+      if(worker_neuron_output.size() < (max_neuron_number * batch_size)) worker_neuron_output.resize(max_neuron_number * batch_size);
+    worker_output_lanes = batch_size;
+  }
+  return job;
+}
+
+void Solution_solver::gather_row_input(Solve_job& job, uint32 row_iterator) const{
+  try{
+    const uint32 lanes = std::max(1u, job.batch_size);
+    vector<sdouble32>::iterator row_input_lanes = job.row_input.begin();
+    for(const Synapse_interval& row_synapse : memory_plan->get_row_inputs(row_iterator)){
+      const sint32 synapse_starts = row_synapse.starts();
+      const uint32 synapse_size = row_synapse.interval_size();
+      if(row_synapse.delayed()){ /* The data of the Neurons from the previous job */
+        const vector<sdouble32>& past = (0 < job.batch_size)?(batch_past_data):(past_data);
+        const uint32 first_lane = synapse_starts * lanes;
+        if(checked && (past.size() < (first_lane + synapse_size * lanes)))
+          throw "Row input is out of bounds of the past Neuron data!";
+        row_input_lanes = std::copy_n(past.begin() + first_lane, synapse_size * lanes, row_input_lanes);
+      }else if(Synapse_iterator::is_index_input(synapse_starts)){ /* The network inputs of every sample are next to each other */
+        const uint32 first_input = Synapse_iterator::input_index_from_synapse_index_unsafe(synapse_starts);
+        if(checked && (job.input->size() < ((first_input + synapse_size) * lanes)))
+          throw "Row input is out of bounds of the network input!";
+        if(0 < solution.input_transforms_size()){ /* The inputs are preprocessed as they are gathered */
+          for(uint32 input_index = first_input; input_index < (first_input + synapse_size); ++input_index){
+            const Input_transform& transform = solution.input_transforms(input_index);
+            row_input_lanes = std::transform(
+              job.input->begin() + input_index * lanes, job.input->begin() + (input_index + 1) * lanes, row_input_lanes,
+              [&transform](sdouble32 input){ return Input_transformer::get_value(transform, input); }
+            );
+          }
+        }else row_input_lanes = std::copy_n(job.input->begin() + first_input * lanes, synapse_size * lanes, row_input_lanes);
+      }else{
+        const uint32 first_lane = synapse_starts * lanes;
+        if(checked && (job.neuron_data.size() < (first_lane + synapse_size * lanes)))
+          throw "Row input is out of bounds of the Neuron data!";
+        row_input_lanes = std::copy_n(job.neuron_data.begin() + first_lane, synapse_size * lanes, row_input_lanes);
+      }
+    }
+  }catch(...){ /* No @Partial_solution of the row is solving the job yet, so the error can be stored freely */
+    if(!job.error) job.error = std::current_exception();
+  }
+}
+
+void Solution_solver::start_job(shared_ptr<Solve_job> job){
+  job->sequence = jobs_submitted;
+  ++jobs_submitted;
+  jobs_in_flight.push_back(job);
+  if(has_past_inputs && (1 < jobs_in_flight.size())){ /* The first row is started once the job before it is finished */
+    job->gathered_row = row_not_gathered;
+  }else start_first_row(std::move(job));
+}
+
+void Solution_solver::start_first_row(shared_ptr<Solve_job> job){
+  if(has_past_inputs){ /* Every previous job is finished, so their Neuron data is in the past data already */
+    if((0 < job->batch_size)&&(batch_size_in_past != job->batch_size)){ /* A batch of another size starts its own sequences */
+      batch_past_data.assign(past_data.size() * job->batch_size, 0.0);
+      batch_size_in_past = job->batch_size;
+    }
+    gather_row_input(*job, 0);
+    job->gathered_row = 0;
+  }
+  for(uint32 col_iterator = 0; col_iterator < solution.cols(0); ++col_iterator){
+    if(partial_jobs_done[col_iterator] == job->sequence) /* The partial is done with every previous job */
+      push_partial(job, 0, col_iterator);
+  }
+}
+
+void Solution_solver::store_past_data(const Solve_job& job){
+  const uint32 lanes = std::max(1u, job.batch_size);
+  vector<sdouble32>::iterator past_lanes = (0 < job.batch_size)?(batch_past_data.begin()):(past_data.begin());
+  Synapse_iterator(memory_plan->get_past_slots()).skim_inline([&](int synapse_starts, unsigned int synapse_size){
+    past_lanes = std::copy_n(job.neuron_data.begin() + synapse_starts * lanes, synapse_size * lanes, past_lanes);
+  });
+}
+
+void Solution_solver::push_partial(shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator){
+  const uint32 partial_index = row_first_partial[row_iterator] + col_iterator;
+  if(0 < job->batch_size) /* The ranges of the partial solve the lanes in parallel, so the lanes are prepared before them */
+    partial_solvers[partial_index].prepare_batch(job->batch_size);
+  if(staged_slot_none != partial_staged_slot[partial_index]){ /* The stages read the outputs of the ones before them from the job */
+    vector<sdouble32>& staged_output = job->staged_outputs[partial_staged_slot[partial_index]];
+    const uint32 staged_output_size = partial_solvers[partial_index].get_internal_neuron_number() * std::max(1u, job->batch_size);
+    if(staged_output.size() < staged_output_size) staged_output.resize(staged_output_size);
+  }
+  job->partial_stages[partial_index] = partial_first_stage[partial_index];
+  push_stage(job, row_iterator, col_iterator);
+}
+
+void Solution_solver::push_stage(shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator){
+  const uint32 partial_index = row_first_partial[row_iterator] + col_iterator;
+  const uint16 node = partial_node[partial_index];
+  const uint32 stage = job->partial_stages[partial_index];
+  job->unsolved_ranges[partial_index] = stage_first_range[stage + 1] - stage_first_range[stage];
+  for(uint32 range_index = stage_first_range[stage]; range_index < stage_first_range[stage + 1]; ++range_index){
+    uint32 task_index;
+    if(0 < free_partial_tasks.size()){
+      task_index = free_partial_tasks.back();
+      free_partial_tasks.pop_back();
+    }else{
+      task_index = partial_tasks.size();
+      partial_tasks.push_back(Partial_task());
+    }
+    partial_tasks[task_index] = {job, row_iterator, col_iterator, range_index};
+    ++queued_tasks;
+    workers->push([this, task_index](uint16 worker_index){ /* Capturing only the solver and an index keeps the task inside the std::function */
+      solve_next_partial(task_index, worker_index);
+    }, node);
+  }
+}
+
+void Solution_solver::solve_next_partial(uint32 task_index, uint16 worker_index){
+  Partial_task task;
+  {
+    std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+    task = std::move(partial_tasks[task_index]);
+    free_partial_tasks.push_back(task_index);
+  }
+  solve_a_partial(std::move(task.job), task.row_iterator, task.col_iterator, task.range_index, worker_index);
+  std::lock_guard<std::mutex> my_lock(scheduler_mutex); /* The last access of the task to the solver, which may be destroyed after it */
+  --queued_tasks;
+  if(0 == queued_tasks) jobs_finished.notify_all();
+}
+
+void Solution_solver::divide_into_ranges(void){
+  partial_first_stage = vector<uint32>(solution.partial_solutions_size() + 1, 0);
+  stage_first_range = vector<uint32>(1, 0);
+  for(int partial_index = 0; partial_index < solution.partial_solutions_size(); ++partial_index){
+    const uint32 neuron_number = solution.partial_solutions(partial_index).internal_neuron_number();
+    const vector<uint32>& wavefronts = partial_solvers[partial_index].get_wavefronts();
+    uint32 serial_start = 0; /* The first Neuron not yet in any stage */
+    if(1 < workers->get_number_of_workers()){ /* Divide the wavefronts large enough between the workers */
+      for(uint32 wavefront_iterator = 0; wavefront_iterator <= wavefronts.size(); ++wavefront_iterator){
+        const uint32 wavefront_start = (0 == wavefront_iterator)?(0u):(wavefronts[wavefront_iterator - 1]);
+        const uint32 wavefront_end = (wavefront_iterator < wavefronts.size())?(wavefronts[wavefront_iterator]):(neuron_number);
+        const uint32 wavefront_size = wavefront_end - wavefront_start;
+        if((2 * min_neurons_in_range) <= wavefront_size){
+          if(serial_start < wavefront_start){ /* The small wavefronts before it are solved by one worker in one stage */
+            neuron_ranges.push_back({serial_start, wavefront_start});
+            stage_first_range.push_back(neuron_ranges.size());
+          }
+          const uint32 neurons_in_range = std::max(min_neurons_in_range, (wavefront_size + number_of_threads - 1) / number_of_threads);
+          const uint32 number_of_ranges = wavefront_size / neurons_in_range;
+          for(uint32 range_iterator = 0; range_iterator < number_of_ranges; ++range_iterator){
+            neuron_ranges.push_back({
+              wavefront_start + (range_iterator * wavefront_size) / number_of_ranges,
+              wavefront_start + ((range_iterator + 1) * wavefront_size) / number_of_ranges
+            });
+          }
+          stage_first_range.push_back(neuron_ranges.size());
+          serial_start = wavefront_end;
         }
-        std::for_each(solve_threads.begin(),solve_threads.end(),[](thread& solve_thread){
-          if(true == solve_thread.joinable())solve_thread.join();
-        });
-        solve_threads.clear();
       }
     }
-    return {neuron_data.end() - solution.output_neuron_number(),neuron_data.end()}; /* Return with the data of the last row */
-  }else throw "A solution of 0 rows!";
+    if(serial_start < neuron_number){
+      neuron_ranges.push_back({serial_start, neuron_number});
+      stage_first_range.push_back(neuron_ranges.size());
+    }
+    partial_first_stage[partial_index + 1] = stage_first_range.size() - 1;
+  }
+
+  /* A job solves one row at a time, so the partials of every row in multiple stages take the output slots of the job from the first one */
+  partial_staged_slot = vector<uint32>(solution.partial_solutions_size(), staged_slot_none);
+  number_of_staged_slots = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    uint32 staged_slots_in_row = 0;
+    for(uint32 partial_index = row_first_partial[row_iterator]; partial_index < row_first_partial[row_iterator + 1]; ++partial_index)
+      if(1 < (partial_first_stage[partial_index + 1] - partial_first_stage[partial_index]))
+        partial_staged_slot[partial_index] = staged_slots_in_row++;
+    number_of_staged_slots = std::max(number_of_staged_slots, staged_slots_in_row);
+  }
+  partial_tasks.reserve(neuron_ranges.size()); /* Enough for a job to be solved without allocations */
+  free_partial_tasks.reserve(neuron_ranges.size());
+}
+
+void Solution_solver::assign_nodes(void){
+  partial_node = vector<uint16>(solution.partial_solutions_size(), 0);
+  if(1 < workers->get_number_of_nodes()){
+    for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+      vector<uint64> node_load(workers->get_number_of_nodes(), 0); /* The partials of a row run in parallel, so they are balanced by row */
+      for(uint32 partial_index = row_first_partial[row_iterator]; partial_index < row_first_partial[row_iterator + 1]; ++partial_index){
+        const uint16 node = std::min_element(node_load.begin(), node_load.end()) - node_load.begin();
+        partial_node[partial_index] = node;
+        const Partial_solution& partial = solution.partial_solutions(partial_index);
+        node_load[node] += partial.weight_table_size() + (partial.half_weight_table().size() / sizeof(uint16)) + 1;
+      }
+    }
+  }
+}
+
+void Solution_solver::refresh_weights(void){
+  for(uint32 partial_index = 0; partial_index < node_weight_tables.size(); ++partial_index){
+    const Partial_solution& partial = solution.partial_solutions(partial_index);
+    const char* weights = partial.half_weight_table().data();
+    std::size_t weight_bytes = partial.half_weight_table().size();
+    if(WEIGHT_STORAGE_DOUBLE == partial.weight_storage()){
+      weights = reinterpret_cast<const char*>(partial.weight_table().data());
+      weight_bytes = partial.weight_table_size() * sizeof(sdouble32);
+    }
+    Node_weight_table& weight_table = node_weight_tables[partial_index];
+    const std::size_t table_bytes = ((weight_bytes + page_bytes - 1) / page_bytes) * page_bytes; /* No page is shared with other data */
+    const bool allocated = (weight_table.size() != table_bytes);
+    if(allocated) weight_table.resize(table_bytes);
+    std::copy(weights, weights + weight_bytes, weight_table.begin());
+    if(allocated){ /* The weights of the partials are read by the workers of their node */
+      numa_topology->place_on_node(weight_table.data(), weight_bytes, partial_node[partial_index]);
+      partial_solvers[partial_index].set_weight_data(weight_table.data());
+    }
+  }
 }
 
-void Solution_solver::solve_a_partial(vector<sdouble32>& input, uint32 row_iterator, uint32 col_iterator, uint32 partial_solution_start){
+void Solution_solver::place_neuron_data(const Solve_job& job) const{
+  const uint32 lanes = std::max(1u, job.batch_size);
+  for(int partial_index = 0; partial_index < solution.partial_solutions_size(); ++partial_index){
+    Synapse_iterator(memory_plan->get_partial_outputs(partial_index)).skim_inline([&](int synapse_starts, unsigned int synapse_size){
+      numa_topology->place_on_node(
+        job.neuron_data.data() + synapse_starts * lanes, synapse_size * lanes * sizeof(sdouble32), partial_node[partial_index]
+      );
+    });
+  }
+}
+
+void Solution_solver::solve_a_partial(
+  shared_ptr<Solve_job> job, uint32 row_iterator, uint32 col_iterator, uint32 range_index, uint16 worker_index
+){
+  shared_ptr<Solve_job> finished_job;
+  shared_ptr<Solve_job> next_job;
+
+  const uint32 partial_index = row_first_partial[row_iterator] + col_iterator;
+  const Neuron_range& range = neuron_ranges[range_index];
+  try{
+    vector<sdouble32>& collected_output = (staged_slot_none != partial_staged_slot[partial_index])
+      ?(job->staged_outputs[partial_staged_slot[partial_index]]):(worker_neuron_outputs[worker_index]);
+    const uint32 lanes = std::max(1u, job->batch_size);
+    if(0 < job->batch_size){
+      Partial_solution_solver& partial_solver = partial_solvers[partial_index];
+      if(collected_output.size() < (partial_solver.get_internal_neuron_number() * lanes))
+        collected_output.resize(partial_solver.get_internal_neuron_number() * lanes);
+      partial_solver.solve_batch(job->row_input, collected_output, lanes, range.first_neuron, range.end_neuron, true);
+    }else{ /* Run the partial solution solver on the input gathered for the row, after the stages before the range */
+      partial_solvers[partial_index].solve(job->row_input, collected_output, range.first_neuron, range.end_neuron, true);
+    }
+
+    uint32 output_iterator = 0; /* The first Neuron of the partial in the synapse */
+    partial_solver_output_maps[partial_index].skim_inline([&](int partial_output_synapse_starts, unsigned int partial_output_synapse_size){
+      const uint32 first_output = std::max(output_iterator, range.first_neuron); /* Only the outputs inside the range are copied */
+      const uint32 end_output = std::min(output_iterator + partial_output_synapse_size, range.end_neuron);
+      if(first_output < end_output){
+        const uint32 copy_from = first_output * lanes; /* Every Neuron is stored in as many lanes as there are samples */
+        const uint32 copy_to = (partial_output_synapse_starts + first_output - output_iterator) * lanes;
+        const uint32 copy_size = (end_output - first_output) * lanes;
+        if(checked && (
+          (collected_output.size() < (copy_from + copy_size))
+          ||(0 > partial_output_synapse_starts)
+          ||(job->neuron_data.size() < (copy_to + copy_size))
+        ))throw "Partial solution output is out of bounds!";
+        std::copy( /* Save output into the slots of the Neurons */
+          collected_output.begin() + copy_from, collected_output.begin() + copy_from + copy_size,
+          job->neuron_data.begin() + copy_to
+        );
+      }
+      output_iterator += partial_output_synapse_size;
+    });
+  }catch(...){ /* The job still needs to go through every row, so the jobs after it can continue */
+    std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+    if(!job->error) job->error = std::current_exception();
+  }
 
-  using std::min;
-  using std::max;
+  bool row_finished = false;
+  { /* Update the scheduling state and continue with whatever became solvable */
+    std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+    --job->unsolved_ranges[partial_index];
+    if(0 < job->unsolved_ranges[partial_index]) return; /* The other ranges of the stage are still being solved */
+    if((job->partial_stages[partial_index] + 1) < partial_first_stage[partial_index + 1]){ /* The next wavefronts of the partial follow */
+      ++job->partial_stages[partial_index];
+      push_stage(job, row_iterator, col_iterator);
+      return;
+    }
+    ++partial_jobs_done[partial_index];
+    --job->unsolved_partials_in_row[row_iterator];
+    if(0 == job->unsolved_partials_in_row[row_iterator]){ /* The row is finished with the job */
+      if(static_cast<int>(row_iterator + 1) < solution.cols_size()){
+        row_finished = true;
+      }else{ /* Jobs finish in order of submission, because the last row solves them in order */
+        finished_job = job;
+        jobs_in_flight.pop_front();
+        if(has_past_inputs) store_past_data(*job);
+      }
+    }
+    next_job = get_job(job->sequence + 1);
+    if( /* The next job is waiting for this partial, and its input for the row is already gathered */
+      (nullptr != next_job)&&(row_iterator == next_job->gathered_row)
+    )push_partial(next_job, row_iterator, col_iterator);
+    if( /* The next job is waiting for the Neuron data of this one */
+      (nullptr != finished_job)&&(nullptr != next_job)&&(row_not_gathered == next_job->gathered_row)
+    )start_first_row(next_job);
+  }
+
+  if(row_finished){ /* Gather the input of the next row, then start its partials which are free */
+    gather_row_input(*job, row_iterator + 1);
+    std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+    job->gathered_row = row_iterator + 1;
+    for(uint32 next_col_iterator = 0; next_col_iterator < solution.cols(row_iterator + 1); ++next_col_iterator){
+      if(partial_jobs_done[row_first_partial[row_iterator + 1] + next_col_iterator] == job->sequence)
+        push_partial(job, row_iterator + 1, next_col_iterator);
+    }
+  }
 
-  vector<sdouble32> collected_output;
-  uint32 output_iterator = 0;
-  partial_solvers[row_iterator][col_iterator].collect_input_data(input,neuron_data); /* Collect the input for the partial solution solver */
-  collected_output = partial_solvers[row_iterator][col_iterator].solve(); /* Run the partial solution solver */
+  if(nullptr != finished_job){ /* Return with the data of the output Neurons */
+    if(nullptr != finished_job->output){ /* The caller is waiting for the job, and takes care of the error */
+      if(!finished_job->error) copy_outputs(*finished_job, *finished_job->output);
+      std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+      finished_job->finished = true;
+    }else{
+      if(finished_job->error){
+        finished_job->result.set_exception(finished_job->error);
+      }else{
+        vector<sdouble32> result(solution.output_neuron_number() * std::max(1u, finished_job->batch_size));
+        copy_outputs(*finished_job, result);
+        finished_job->result.set_value(std::move(result));
+      }
+      std::lock_guard<std::mutex> my_lock(scheduler_mutex);
+      finished_job->finished = true;
+      finished_job->error = nullptr;
+      finished_job->shared_input.reset();
+      idle_jobs.push_back(std::move(finished_job));
+    }
+    jobs_finished.notify_all();
+  }
+}
 
-  partial_solver_output_maps[row_iterator][col_iterator].skim([&](int partial_output_synapse_starts, unsigned int partial_output_synapse_size){
-    swap_ranges( /* Save output into the internal neuron memory */
-      collected_output.begin() + output_iterator,
-      collected_output.begin() + output_iterator + partial_output_synapse_size,
-      neuron_data.begin() + partial_output_synapse_starts
-    );
-    output_iterator += partial_output_synapse_size;
+void Solution_solver::copy_outputs(const Solve_job& job, vector<sdouble32>& output) const{
+  const uint32 lanes = std::max(1u, job.batch_size);
+  vector<sdouble32>::iterator output_lanes = output.begin();
+  Synapse_iterator(memory_plan->get_output_slots()).skim_inline([&](int synapse_starts, unsigned int synapse_size){
+    output_lanes = std::copy_n(job.neuron_data.begin() + synapse_starts * lanes, synapse_size * lanes, output_lanes);
   });
 }
 
+void Solution_solver::refresh_neurons(void){
+  for(Partial_solution_solver& partial_solver : partial_solvers)
+    partial_solver.refresh_neurons();
+}
+
+bool Solution_solver::is_valid(void) const{
+  int number_of_partials = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    if(0 == solution.cols(row_iterator)) return false; /* A solution row of 0 columns */
+    number_of_partials += solution.cols(row_iterator);
+  }
+  if(
+    (number_of_partials != solution.partial_solutions_size())
+    ||(solution.neuron_number() < solution.output_neuron_number())
+  )return false;
+
+  Solution_structure_verifier structure(solution.neuron_number(), solution.output_neuron_number());
+  int partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator){
+      if(!structure.add_partial(solution.partial_solutions(partial_iterator), row_iterator)) return false;
+      ++partial_iterator;
+    }
+  }
+  return structure.is_complete();
+}
+
 } /* namespace sparse_net_library */
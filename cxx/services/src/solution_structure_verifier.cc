@@ -0,0 +1,48 @@
+#include "services/solution_structure_verifier.h"
+#include "services/synapse_iterator.h"
+
+namespace sparse_net_library{
+
+bool Solution_structure_verifier::add_partial(const Partial_solution& partial, uint32 row_index){
+  const sint32 row = static_cast<sint32>(row_index);
+  uint32 number_of_outputs = 0;
+  for(const Synapse_interval& output_synapse : partial.output_data()){
+    if(
+      (Synapse_iterator::is_index_input(output_synapse.starts()))
+      ||(neuron_number < (output_synapse.starts() + output_synapse.interval_size()))
+    )return false;
+    for(uint32 neuron_index = output_synapse.starts(); neuron_index < (output_synapse.starts() + output_synapse.interval_size()); ++neuron_index){
+      if(-1 != neuron_row[neuron_index]) return false; /* The Neuron is already calculated by another @Partial_solution */
+      neuron_row[neuron_index] = row;
+    }
+    number_of_outputs += output_synapse.interval_size();
+  }
+  if(number_of_outputs != partial.internal_neuron_number()) return false;
+
+  for(const Synapse_interval& input_synapse : partial.input_data()){
+    if(input_synapse.delayed()){
+      if(
+        (Synapse_iterator::is_index_input(input_synapse.starts()))
+        ||(neuron_number < (input_synapse.starts() + input_synapse.interval_size()))
+      )return false;
+      delayed_inputs.push_back(input_synapse);
+    }else if(!Synapse_iterator::is_index_input(input_synapse.starts())){ /* Neuron data only from the previous rows */
+      if(neuron_number < (input_synapse.starts() + input_synapse.interval_size())) return false;
+      for(uint32 neuron_index = input_synapse.starts(); neuron_index < (input_synapse.starts() + input_synapse.interval_size()); ++neuron_index)
+        if((0 > neuron_row[neuron_index])||(row <= neuron_row[neuron_index])) return false;
+    }
+  }
+  return true;
+}
+
+bool Solution_structure_verifier::is_complete(void) const{
+  if(neuron_number < output_neuron_number) return false;
+  for(uint32 neuron_index = (neuron_number - output_neuron_number); neuron_index < neuron_number; ++neuron_index)
+    if(-1 == neuron_row[neuron_index]) return false; /* An output Neuron is not calculated */
+  for(const Synapse_interval& input_synapse : delayed_inputs) /* The data of the previous run is available from any calculated Neuron */
+    for(uint32 neuron_index = input_synapse.starts(); neuron_index < (input_synapse.starts() + input_synapse.interval_size()); ++neuron_index)
+      if(0 > neuron_row[neuron_index]) return false;
+  return true;
+}
+
+} /* namespace sparse_net_library */
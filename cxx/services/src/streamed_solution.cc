@@ -0,0 +1,100 @@
+#include "services/streamed_solution.h"
+
+#include <string>
+
+namespace sparse_net_library{
+
+namespace{
+
+const std::string file_signature = "SNLROWS1";
+
+void write_number(std::ostream& stream, uint64 number){
+  char bytes[sizeof(uint64)];
+  for(uint32 byte_iterator = 0; byte_iterator < sizeof(uint64); ++byte_iterator)
+    bytes[byte_iterator] = static_cast<char>((number >> (8 * byte_iterator)) & 0xFFu);
+  stream.write(bytes, sizeof(uint64));
+}
+
+uint64 read_number(std::istream& stream){
+  unsigned char bytes[sizeof(uint64)];
+  if(!stream.read(reinterpret_cast<char*>(bytes), sizeof(uint64))) throw "Unable to read the Solution file!";
+  uint64 number = 0;
+  for(uint32 byte_iterator = 0; byte_iterator < sizeof(uint64); ++byte_iterator)
+    number |= static_cast<uint64>(bytes[byte_iterator]) << (8 * byte_iterator);
+  return number;
+}
+
+} /* namespace */
+
+void Streamed_solution::write(const Solution& solution, const std::string& file_name){
+  Solution head = solution;
+  head.clear_partial_solutions();
+  const std::string head_bytes = head.SerializeAsString();
+
+  /* The positions of the rows are known from the sizes of the partial solutions in them */
+  vector<uint64> row_positions(solution.cols_size() + 1);
+  row_positions[0] = file_signature.size() + sizeof(uint64) + head_bytes.size() + (sizeof(uint64) * row_positions.size());
+  int partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution.cols_size(); ++row_iterator){
+    row_positions[row_iterator + 1] = row_positions[row_iterator];
+    for(uint32 col_iterator = 0; col_iterator < solution.cols(row_iterator); ++col_iterator, ++partial_iterator)
+      row_positions[row_iterator + 1] += sizeof(uint64) + solution.partial_solutions(partial_iterator).ByteSizeLong();
+  }
+
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  if(!file.is_open()) throw "Unable to open the Solution file!";
+  file.write(file_signature.data(), file_signature.size());
+  write_number(file, head_bytes.size());
+  file.write(head_bytes.data(), head_bytes.size());
+  for(uint64 row_position : row_positions) write_number(file, row_position);
+  std::string partial_bytes;
+  for(const Partial_solution& partial : solution.partial_solutions()){
+    partial.SerializeToString(&partial_bytes);
+    write_number(file, partial_bytes.size());
+    file.write(partial_bytes.data(), partial_bytes.size());
+  }
+  if(!file) throw "Unable to write the Solution file!";
+}
+
+Streamed_solution::Streamed_solution(const std::string& file_name)
+: file(file_name, std::ios::binary)
+{
+  if(!file.is_open()) throw "Unable to open the Solution file!";
+  std::string signature(file_signature.size(), '\0');
+  if((!file.read(&signature[0], signature.size()))||(file_signature != signature))
+    throw "Invalid Solution file!";
+  std::string head_bytes(read_number(file), '\0');
+  if((!file.read(&head_bytes[0], head_bytes.size()))||(!head.ParseFromString(head_bytes)))
+    throw "Invalid Solution file!";
+  row_positions = vector<uint64>(head.cols_size() + 1);
+  for(uint64& row_position : row_positions) row_position = read_number(file);
+  for(int row_iterator = 0; row_iterator < head.cols_size(); ++row_iterator)
+    if(row_positions[row_iterator + 1] < row_positions[row_iterator]) throw "Invalid Solution file!";
+}
+
+vector<Partial_solution> Streamed_solution::read_row(uint32 row_iterator) const{
+  std::string row_bytes(get_row_bytes(row_iterator), '\0');
+  {
+    std::lock_guard<std::mutex> my_lock(file_mutex);
+    file.clear();
+    file.seekg(row_positions[row_iterator]);
+    if(!file.read(&row_bytes[0], row_bytes.size())) throw "Unable to read the Solution file!";
+  }
+  vector<Partial_solution> partials(head.cols(row_iterator));
+  uint64 position = 0;
+  for(Partial_solution& partial : partials){
+    if(row_bytes.size() < (position + sizeof(uint64))) throw "Invalid Solution file!";
+    uint64 partial_size = 0;
+    for(uint32 byte_iterator = 0; byte_iterator < sizeof(uint64); ++byte_iterator, ++position)
+      partial_size |= static_cast<uint64>(static_cast<unsigned char>(row_bytes[position])) << (8 * byte_iterator);
+    if(
+      (row_bytes.size() < (position + partial_size))
+      ||(!partial.ParseFromArray(row_bytes.data() + position, partial_size))
+    )throw "Invalid Solution file!";
+    position += partial_size;
+  }
+  if(position != row_bytes.size()) throw "Invalid Solution file!";
+  return partials;
+}
+
+} /* namespace sparse_net_library */
@@ -0,0 +1,109 @@
+#include "services/streamed_solution_solver.h"
+#include "services/solution_structure_verifier.h"
+
+#include <algorithm>
+#include <future>
+
+namespace sparse_net_library{
+
+Streamed_solution_solver::Streamed_solution_solver(const Streamed_solution& solution_, Service_context context)
+: solution(solution_), neuron_data(solution_.get_head().neuron_number(), 0.0)
+, checked(context.get_checked_solve())
+{
+  const Solution& head = solution.get_head();
+  row_first_partial = vector<uint32>(head.cols_size() + 1, 0);
+  for(int row_iterator = 0; row_iterator < head.cols_size(); ++row_iterator)
+    row_first_partial[row_iterator + 1] = row_first_partial[row_iterator] + head.cols(row_iterator);
+  workers = std::make_unique<Worker_pool>(context.get_max_solve_threads());
+  worker_inputs = vector<vector<sdouble32>>(workers->get_number_of_workers());
+  worker_outputs = vector<vector<sdouble32>>(workers->get_number_of_workers());
+  verify_rows();
+}
+
+void Streamed_solution_solver::verify_rows(void){
+  const Solution& head = solution.get_head();
+  if(head.neuron_number() < head.output_neuron_number()) throw "Invalid Solution!";
+  partial_memories = vector<vector<sdouble32>>(row_first_partial.back());
+  Solution_structure_verifier structure(head.neuron_number(), head.output_neuron_number());
+  for(int row_iterator = 0; row_iterator < head.cols_size(); ++row_iterator){
+    if(0 == head.cols(row_iterator)) throw "Invalid Solution!"; /* A solution row of 0 columns */
+    unique_ptr<Loaded_row> row = load_row(row_iterator); /* The @Partial_solution elements are verified by their solvers */
+    for(uint32 col_iterator = 0; col_iterator < head.cols(row_iterator); ++col_iterator){
+      const Partial_solution& partial = row->partials[col_iterator];
+      if(!structure.add_partial(partial, row_iterator)) throw "Invalid Solution!";
+      required_input_size = std::max(required_input_size, row->solvers[col_iterator].get_required_input_size());
+      partial_memories[row_first_partial[row_iterator] + col_iterator].assign(row->solvers[col_iterator].get_neuron_memory_size(), 0.0);
+    }
+  }
+  if(!structure.is_complete()) throw "Invalid Solution!";
+}
+
+unique_ptr<Streamed_solution_solver::Loaded_row> Streamed_solution_solver::load_row(uint32 row_iterator) const{
+  unique_ptr<Loaded_row> row = std::make_unique<Loaded_row>();
+  row->partials = solution.read_row(row_iterator);
+  for(const Partial_solution& partial : row->partials) /* The Neuron data of the previous run is overwritten row by row */
+    for(const Synapse_interval& input_synapse : partial.input_data())
+      if(input_synapse.delayed()) throw "Delayed Neuron inputs are not supported in a streamed Solution!";
+  row->solvers.reserve(row->partials.size());
+  for(const Partial_solution& partial : row->partials){ /* The partials are not moved after this, so the solvers can refer to them */
+    row->solvers.push_back(Partial_solution_solver(partial, checked));
+    row->solvers.back().set_input_transforms(solution.get_head().input_transforms());
+  }
+  return row;
+}
+
+void Streamed_solution_solver::solve_row(uint32 row_iterator, Loaded_row& row, const vector<sdouble32>& input){
+  workers->run_in_chunks(row.solvers.size(), [&](uint16 chunk_index, uint32 chunk_start, uint32 chunk_end){
+    vector<sdouble32>& collected_input = worker_inputs[chunk_index];
+    vector<sdouble32>& collected_output = worker_outputs[chunk_index];
+    for(uint32 col_iterator = chunk_start; col_iterator < chunk_end; ++col_iterator){
+      Partial_solution_solver& partial_solver = row.solvers[col_iterator];
+      vector<sdouble32>& memory = partial_memories[row_first_partial[row_iterator] + col_iterator];
+      if(collected_input.size() < partial_solver.get_input_size()) collected_input.resize(partial_solver.get_input_size());
+      if(collected_output.size() < partial_solver.get_internal_neuron_number()) collected_output.resize(partial_solver.get_internal_neuron_number());
+      partial_solver.collect_input_data(input, neuron_data, collected_input);
+      partial_solver.swap_neuron_memory(memory);
+      try{
+        partial_solver.solve(collected_input, collected_output);
+      }catch(...){ /* The memory shall outlive the solver in any case */
+        partial_solver.swap_neuron_memory(memory);
+        throw;
+      }
+      partial_solver.swap_neuron_memory(memory);
+      uint32 output_iterator = 0;
+      for(const Synapse_interval& output_synapse : row.partials[col_iterator].output_data()){ /* Save output into the data of the Neurons */
+        std::copy(
+          collected_output.begin() + output_iterator, collected_output.begin() + output_iterator + output_synapse.interval_size(),
+          neuron_data.begin() + output_synapse.starts()
+        );
+        output_iterator += output_synapse.interval_size();
+      }
+    }
+  });
+}
+
+vector<sdouble32> Streamed_solution_solver::solve(const vector<sdouble32>& input){
+  if(input.size() < required_input_size) throw "Input is too small for the Solution!";
+  const uint32 number_of_rows = solution.get_number_of_rows();
+  std::future<unique_ptr<Loaded_row>> next_row;
+  if(0 < number_of_rows) next_row = std::async(std::launch::async, [this](){ return load_row(0); });
+  for(uint32 row_iterator = 0; row_iterator < number_of_rows; ++row_iterator){
+    unique_ptr<Loaded_row> row = next_row.get();
+    uint64 row_bytes_in_memory = solution.get_row_bytes(row_iterator);
+    if((row_iterator + 1) < number_of_rows){ /* Read the next row while this one is being solved */
+      next_row = std::async(std::launch::async, [this, row_iterator](){ return load_row(row_iterator + 1); });
+      row_bytes_in_memory += solution.get_row_bytes(row_iterator + 1);
+    }
+    max_row_bytes_in_memory = std::max(max_row_bytes_in_memory, row_bytes_in_memory);
+    solve_row(row_iterator, *row, input);
+  } /* The row is dropped once it is solved */
+  const Solution& head = solution.get_head();
+  return vector<sdouble32>(neuron_data.end() - head.output_neuron_number(), neuron_data.end());
+}
+
+void Streamed_solution_solver::reset(void){
+  for(vector<sdouble32>& memory : partial_memories)
+    std::fill(memory.begin(), memory.end(), 0.0);
+}
+
+} /* namespace sparse_net_library */
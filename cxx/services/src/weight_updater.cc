@@ -0,0 +1,94 @@
+#include "services/weight_updater.h"
+
+#include <algorithm>
+#include <string>
+
+#include "models/half_float.h"
+
+namespace sparse_net_library{
+
+Weight_updater::Weight_updater(Solution& solution_)
+: solution(solution_)
+{
+  uint32 number_of_net_weights = 0;
+  uint32 number_of_slots = 0;
+  for(const Partial_solution& partial : solution.partial_solutions()){
+    const uint32 weight_table_size = (WEIGHT_STORAGE_DOUBLE == partial.weight_storage())
+      ? partial.weight_table_size() : (partial.half_weight_table().size() / sizeof(uint16));
+    if(static_cast<uint32>(partial.weight_sources_size()) != weight_table_size)
+      throw "The Partial solution doesn't map its weights to the net!";
+    for(uint32 weight_source : partial.weight_sources())
+      number_of_net_weights = std::max(number_of_net_weights, weight_source + 1);
+    number_of_slots += weight_table_size;
+  }
+
+  /* Count the slots of every net weight, then place them by the counts */
+  net_weight_first_slot = vector<uint32>(number_of_net_weights + 1, 0);
+  for(const Partial_solution& partial : solution.partial_solutions())
+    for(uint32 weight_source : partial.weight_sources())
+      ++net_weight_first_slot[weight_source + 1];
+  for(uint32 weight_iterator = 0; weight_iterator < number_of_net_weights; ++weight_iterator)
+    net_weight_first_slot[weight_iterator + 1] += net_weight_first_slot[weight_iterator];
+  weight_slots = vector<Weight_slot>(number_of_slots);
+  vector<uint32> placed_slots(net_weight_first_slot.begin(), net_weight_first_slot.end() - 1);
+  vector<sint32> memory_filter_of;
+  for(int partial_index = 0; partial_index < solution.partial_solutions_size(); ++partial_index){
+    const Partial_solution& partial = solution.partial_solutions(partial_index);
+    memory_filter_of.assign(partial.weight_sources_size(), -1);
+    for(uint32 neuron_iterator = 0; neuron_iterator < static_cast<uint32>(partial.memory_filter_index_size()); ++neuron_iterator){
+      const sdouble32 memory_filter_index = partial.memory_filter_index(neuron_iterator);
+      if((0.0 <= memory_filter_index)&&(memory_filter_index < memory_filter_of.size()))
+        memory_filter_of[static_cast<uint32>(memory_filter_index)] = neuron_iterator;
+    }
+    for(int weight_index = 0; weight_index < partial.weight_sources_size(); ++weight_index){
+      weight_slots[placed_slots[partial.weight_sources(weight_index)]++] = {
+        static_cast<uint32>(partial_index), static_cast<uint32>(weight_index), memory_filter_of[weight_index]
+      };
+    }
+  }
+}
+
+bool Weight_updater::set_weight(const Weight_slot& slot, sdouble32 weight){
+  Partial_solution& partial = *solution.mutable_partial_solutions(slot.partial_index);
+  if(WEIGHT_STORAGE_DOUBLE == partial.weight_storage()){
+    partial.set_weight_table(slot.weight_index, weight);
+  }else{
+    const uint16 half = Half_float::from_double(partial.weight_storage(), weight);
+    std::string& half_weight_table = *partial.mutable_half_weight_table();
+    half_weight_table[2 * slot.weight_index] = static_cast<char>(half & 0xFFu);
+    half_weight_table[2 * slot.weight_index + 1] = static_cast<char>(half >> 8);
+  }
+  if((0 <= slot.memory_filter_of)&&(slot.memory_filter_of < partial.neuron_memoryless_size())){
+    /* Decided from the net weight, as in Partial_solution_builder, whatever the storage rounds it to */
+    const bool memoryless = (0.0 == weight);
+    if(memoryless != partial.neuron_memoryless(slot.memory_filter_of)){
+      partial.set_neuron_memoryless(slot.memory_filter_of, memoryless);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Weight_updater::update(const SparseNet& net){
+  if(static_cast<uint32>(net.weight_table_size()) < get_number_of_net_weights())
+    throw "The weight table of the net is smaller than the one of the Solution!";
+  bool neurons_changed = false;
+  for(uint32 weight_iterator = 0; weight_iterator < get_number_of_net_weights(); ++weight_iterator)
+    for(uint32 slot_index = net_weight_first_slot[weight_iterator]; slot_index < net_weight_first_slot[weight_iterator + 1]; ++slot_index)
+      neurons_changed |= set_weight(weight_slots[slot_index], net.weight_table(weight_iterator));
+  return neurons_changed;
+}
+
+bool Weight_updater::update(const vector<uint32>& weight_indices, const vector<sdouble32>& weights){
+  if(weight_indices.size() != weights.size()) throw "Number of weight indices and weights don't match!";
+  bool neurons_changed = false;
+  for(uint32 update_iterator = 0; update_iterator < weight_indices.size(); ++update_iterator){
+    const uint32 weight_iterator = weight_indices[update_iterator];
+    if(get_number_of_net_weights() <= weight_iterator) continue; /* The weight is not used by the @Solution */
+    for(uint32 slot_index = net_weight_first_slot[weight_iterator]; slot_index < net_weight_first_slot[weight_iterator + 1]; ++slot_index)
+      neurons_changed |= set_weight(weight_slots[slot_index], weights[update_iterator]);
+  }
+  return neurons_changed;
+}
+
+} /* namespace sparse_net_library */
@@ -0,0 +1,169 @@
+#include "services/worker_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace sparse_net_library{
+
+namespace{
+
+/* The pool and the index of the worker running on the current thread, so tasks pushed by a task stay with its worker */
+thread_local const Worker_pool* current_pool = nullptr;
+thread_local uint16 current_worker = 0;
+
+} /* namespace */
+
+Worker_pool::Worker_pool(uint16 number_of_workers, const Numa_topology* topology)
+: queued_tasks(0), idle_workers(0), next_worker(0), stolen_tasks(0)
+{
+  number_of_workers = std::max(static_cast<uint16>(1u),number_of_workers);
+  const uint16 number_of_nodes = std::min( /* Every node shall have at least one worker */
+    number_of_workers, static_cast<uint16>((nullptr != topology)?(topology->get_number_of_nodes()):(1u))
+  );
+  for(uint16 worker_iterator = 0; worker_iterator < number_of_workers; ++worker_iterator){ /* Continuous groups of workers on every node */
+    worker_node.push_back((worker_iterator * number_of_nodes) / number_of_workers);
+    if(node_first_worker.size() == worker_node.back()) node_first_worker.push_back(worker_iterator);
+    deques.push_back(std::make_unique<Worker_deque>());
+  }
+  node_first_worker.push_back(number_of_workers);
+  idle_workers_on_node = vector<uint16>(number_of_nodes, 0);
+  node_tasks_queued = vector<std::condition_variable>(number_of_nodes);
+  for(uint16 worker_iterator = 0; worker_iterator < number_of_workers; ++worker_iterator){
+    workers.push_back(std::thread([this, worker_iterator, topology](){
+      if(nullptr != topology) Numa_topology::pin_current_thread(topology->get_node_cpus(worker_node[worker_iterator]));
+      work(worker_iterator);
+    }));
+  }
+}
+
+Worker_pool::~Worker_pool(){
+  { /* Signal the end of the pool, but let the workers empty the deques first */
+    std::lock_guard<std::mutex> my_lock(idle_mutex);
+    stopping = true;
+  }
+  for(std::condition_variable& tasks_queued : node_tasks_queued)
+    tasks_queued.notify_all();
+  std::for_each(workers.begin(),workers.end(),[](std::thread& worker){
+    if(true == worker.joinable())worker.join();
+  });
+}
+
+void Worker_pool::push(function<void(uint16)> task, uint16 node){
+  if(this == current_pool){
+    push_to_worker(std::move(task), current_worker);
+  }else{
+    const uint16 workers_on_node = node_first_worker[node + 1] - node_first_worker[node];
+    push_to_worker(std::move(task), node_first_worker[node] + (next_worker++ % workers_on_node));
+  }
+}
+
+void Worker_pool::push_to_worker(function<void(uint16)> task, uint16 worker_index){
+  {
+    std::lock_guard<std::mutex> my_lock(deques[worker_index]->mutex);
+    deques[worker_index]->tasks.push_back(std::move(task));
+    ++queued_tasks;
+  }
+  if(0 < idle_workers){ /* Otherwise every worker is busy, and takes the task once it's finished */
+    uint16 node_to_wake = worker_node[worker_index];
+    {
+      std::lock_guard<std::mutex> my_lock(idle_mutex);
+      if(0 == idle_workers_on_node[node_to_wake]){ /* Every worker of the node is busy, so an idle worker of another node steals it */
+        for(uint16 node_iterator = 0; node_iterator < idle_workers_on_node.size(); ++node_iterator)
+          if(0 < idle_workers_on_node[node_iterator]) node_to_wake = node_iterator;
+      }
+    }
+    node_tasks_queued[node_to_wake].notify_one();
+  }
+}
+
+bool Worker_pool::take_task(uint16 worker_index, function<void(uint16)>& task){
+  {
+    Worker_deque& own_deque = *deques[worker_index];
+    std::lock_guard<std::mutex> my_lock(own_deque.mutex);
+    if(0 < own_deque.tasks.size()){
+      task = std::move(own_deque.tasks.back());
+      own_deque.tasks.pop_back();
+      --queued_tasks;
+      return true;
+    }
+  }
+  const uint16 node = worker_node[worker_index];
+  const uint16 workers_on_node = node_first_worker[node + 1] - node_first_worker[node];
+  for(uint16 victim_iterator = 1; victim_iterator < workers.size(); ++victim_iterator){
+    uint16 victim; /* The workers of the same node first, starting with the next one, then the workers after the node */
+    if(victim_iterator < workers_on_node){
+      victim = node_first_worker[node] + ((worker_index - node_first_worker[node] + victim_iterator) % workers_on_node);
+    }else{
+      victim = (node_first_worker[node + 1] + victim_iterator - workers_on_node) % workers.size();
+    }
+    if(0 == queued_tasks) return false;
+    Worker_deque& victim_deque = *deques[victim];
+    std::lock_guard<std::mutex> my_lock(victim_deque.mutex);
+    if(0 < victim_deque.tasks.size()){
+      task = std::move(victim_deque.tasks.front());
+      victim_deque.tasks.pop_front();
+      --queued_tasks;
+      ++stolen_tasks;
+      return true;
+    }
+  }
+  return false;
+}
+
+void Worker_pool::run_in_chunks(uint32 number_of_elements, function<void(uint16, uint32, uint32)> task){
+  const uint32 chunk_size = (number_of_elements + workers.size() - 1) / workers.size();
+  uint32 unfinished_chunks = 0;
+  std::exception_ptr error;
+  std::mutex chunks_mutex;
+  std::condition_variable chunks_finished;
+  uint16 chunk_index = 0;
+  for(uint32 chunk_start = 0; chunk_start < number_of_elements; chunk_start += chunk_size, ++chunk_index){
+    const uint32 chunk_end = std::min(number_of_elements, chunk_start + chunk_size);
+    {
+      std::lock_guard<std::mutex> my_lock(chunks_mutex);
+      ++unfinished_chunks;
+    }
+    push_to_worker([&, chunk_index, chunk_start, chunk_end](uint16 worker_index){
+      std::exception_ptr chunk_error;
+      try{
+        task(chunk_index, chunk_start, chunk_end);
+      }catch(...){
+        chunk_error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> my_lock(chunks_mutex);
+      if(!error) error = chunk_error;
+      --unfinished_chunks;
+      if(0 == unfinished_chunks) chunks_finished.notify_all();
+    }, chunk_index); /* Every chunk is queued to its own worker, so chunks are spread between the nodes like the workers are */
+  }
+  {
+    std::unique_lock<std::mutex> my_lock(chunks_mutex);
+    chunks_finished.wait(my_lock,[&unfinished_chunks](){ return (0 == unfinished_chunks); });
+  }
+  if(error) std::rethrow_exception(error);
+}
+
+void Worker_pool::work(uint16 worker_index){
+  current_pool = this;
+  current_worker = worker_index;
+  const uint16 node = worker_node[worker_index];
+  function<void(uint16)> task;
+  while(true){
+    if(take_task(worker_index, task)){
+      task(worker_index);
+      task = nullptr; /* Release whatever the task holds before waiting for the next one */
+      continue;
+    }
+    std::unique_lock<std::mutex> my_lock(idle_mutex);
+    ++idle_workers_on_node[node];
+    ++idle_workers; /* Either a pusher sees the worker as idle, or the worker sees the pushed task */
+    node_tasks_queued[node].wait(my_lock,[this](){
+      return (stopping || (0 < queued_tasks));
+    });
+    --idle_workers;
+    --idle_workers_on_node[node];
+    if(stopping && (0 == queued_tasks)) return; /* Only stopping with empty deques ends the worker */
+  } /* while(true) */
+}
+
+} /* namespace sparse_net_library */
@@ -0,0 +1,81 @@
+#ifndef STREAMED_SOLUTION_H
+#define STREAMED_SOLUTION_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <mutex>
+
+#include "gen/solution.pb.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+
+/**
+ * @brief      A @Solution stored in a file row by row, so it can be solved without the whole of it in memory:
+ *             the rows are read one by one while solving, and dropped once they are solved.
+ *             The file starts with a signature, then the @Solution without its @Partial_solution elements, then
+ *             the position of every row in the file, followed by the rows. Every row consists of its
+ *             @Partial_solution elements, each of them preceded by its size. The sizes and positions are
+ *             stored as 64 bit numbers in little endian order. Reading rows is thread-safe.
+ */
+class Streamed_solution{
+public:
+  /**
+   * @brief      Opens a @Solution file written by @write; throws in case the file can't be opened,
+   *             or its header is invalid.
+   *
+   * @param[in]  file_name  The name of the file
+   */
+  Streamed_solution(const std::string& file_name);
+
+  /**
+   * @brief      Writes the given @Solution into the given file row by row
+   *
+   * @param[in]  solution   The solution to store
+   * @param[in]  file_name  The name of the file
+   */
+  static void write(const Solution& solution, const std::string& file_name);
+
+  /**
+   * @brief      Gets the @Solution without its @Partial_solution elements, describing the number of Neurons,
+   *             outputs and rows.
+   */
+  const Solution& get_head(void) const{
+    return head;
+  }
+
+  uint32 get_number_of_rows(void) const{
+    return head.cols_size();
+  }
+
+  /**
+   * @brief      Gets the size the given row takes up in the file
+   */
+  uint64 get_row_bytes(uint32 row_iterator) const{
+    return row_positions[row_iterator + 1] - row_positions[row_iterator];
+  }
+
+  /**
+   * @brief      Reads the @Partial_solution elements of the given row from the file;
+   *             throws in case they can't be read.
+   *
+   * @param[in]  row_iterator  The index of the row
+   *
+   * @return     The partial solutions in the row
+   */
+  vector<Partial_solution> read_row(uint32 row_iterator) const;
+
+private:
+  Solution head;
+  vector<uint64> row_positions; /* The position of every row in the file, and the size of the file at the end */
+  mutable std::ifstream file;
+  mutable std::mutex file_mutex;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* STREAMED_SOLUTION_H */
@@ -0,0 +1,96 @@
+#ifndef STREAMED_SOLUTION_SOLVER_H
+#define STREAMED_SOLUTION_SOLVER_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <memory>
+
+#include "gen/solution.pb.h"
+#include "models/service_context.h"
+#include "services/streamed_solution.h"
+#include "services/partial_solution_solver.h"
+#include "services/worker_pool.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+using std::unique_ptr;
+
+/**
+ * @brief      Solves a @Streamed_solution out of core: only the row being solved and the row after it are kept
+ *             in memory. While the @Partial_solution elements of a row are solved by the workers, the next row
+ *             is read from the file in the background; a row is dropped as soon as it is solved. Only the
+ *             Neuron data and the memory of the Neurons are kept between the inputs, so the memory needed
+ *             is independent from the number of weights in the @Solution, apart from its two largest rows.
+ *             The structure of every row is verified once in the constructor, which throws if it is invalid;
+ *             the @Partial_solution elements are verified by their solvers every time they are read.
+ *             The referenced @Streamed_solution shall live as long as the solver does.
+ */
+class Streamed_solution_solver{
+public:
+  Streamed_solution_solver(const Streamed_solution& solution_, Service_context context = Service_context());
+
+  /**
+   * @brief      Solves the @Solution for the given input, reading every row of it from the file
+   *
+   * @param[in]  input  The input of the network
+   *
+   * @return     The data of the output Neurons
+   */
+  vector<sdouble32> solve(const vector<sdouble32>& input);
+
+  /**
+   * @brief      Resets the memory of the Neurons
+   */
+  void reset(void);
+
+  /**
+   * @brief      Gets the most bytes of rows read into memory at once so far
+   */
+  uint64 get_max_row_bytes_in_memory(void) const{
+    return max_row_bytes_in_memory;
+  }
+
+private:
+  /**
+   * @brief      A row read into memory, with the solvers of its @Partial_solution elements
+   */
+  struct Loaded_row{
+    vector<Partial_solution> partials;
+    vector<Partial_solution_solver> solvers;
+  };
+
+  /**
+   * @brief      Reads the given row from the file, and constructs the solvers of its @Partial_solution elements.
+   *             Throws if a @Partial_solution has delayed inputs, as the Neuron data of the previous run is overwritten row by row.
+   */
+  unique_ptr<Loaded_row> load_row(uint32 row_iterator) const;
+
+  /**
+   * @brief      Solves the @Partial_solution elements of a loaded row with the workers,
+   *             and writes their outputs into the Neuron data
+   */
+  void solve_row(uint32 row_iterator, Loaded_row& row, const vector<sdouble32>& input);
+
+  /**
+   * @brief      Verifies the structure of the @Solution row by row with a @Solution_structure_verifier, as the @Solution_solver does;
+   *             and prepares the memory of every @Partial_solution. Throws in case the @Solution is invalid.
+   */
+  void verify_rows(void);
+
+  const Streamed_solution& solution;
+  vector<uint32> row_first_partial; /* The index of the first @Partial_solution in every row, and the number of partials at the end */
+  vector<vector<sdouble32>> partial_memories; /* The memory of the Neurons of every @Partial_solution */
+  vector<sdouble32> neuron_data;
+  vector<vector<sdouble32>> worker_inputs; /* Buffers for the inputs and the outputs of the partial solvers in every worker */
+  vector<vector<sdouble32>> worker_outputs;
+  uint32 required_input_size = 0; /* The number of network inputs the partial solutions read from */
+  uint64 max_row_bytes_in_memory = 0;
+  bool checked = false;
+  unique_ptr<Worker_pool> workers;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* STREAMED_SOLUTION_SOLVER_H */
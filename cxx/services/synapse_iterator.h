@@ -94,6 +94,35 @@ public:
   void iterate_unsafe_terminatable(std::function< bool(int) > do_for_each_index, uint32 interval_start, uint32 interval_size = 0) const;
   void iterate_unsafe_terminatable(std::function< bool(unsigned int) > do_for_each_synapse, std::function< bool(int) > do_for_each_index, uint32 interval_start, uint32 interval_size = 0) const;
 
+  /**
+   * @brief      Same as @iterate_unsafe, but the given function is called directly instead of through a std::function,
+   *             so it can be inlined and it doesn't allocate, no matter how much it captures. For the solvers' inner loops.
+   */
+  template<typename Do_for_each_index>
+  void iterate_inline(Do_for_each_index&& do_for_each_index, uint32 interval_start = 0, uint32 interval_size = 0) const{
+    if((0 == interval_size)&&(synapse_interval.get().size() > static_cast<int>(interval_start)))
+      interval_size = synapse_interval.get().size() - interval_start;
+    for(uint32 synapse_iterator = interval_start; synapse_iterator < (interval_start + interval_size); ++synapse_iterator){
+      const Synapse_interval& interval = synapse_interval.get().Get(synapse_iterator);
+      if(!is_index_input(interval.starts())){
+        for(uint32 input_iterator = 0; input_iterator < interval.interval_size(); ++input_iterator)
+          do_for_each_index(interval.starts() + static_cast<sint32>(input_iterator));
+      }else{ /* current element is from the input, iterate in a negative way */
+        for(uint32 input_iterator = 0; input_iterator < interval.interval_size(); ++input_iterator)
+          do_for_each_index(interval.starts() - static_cast<sint32>(input_iterator));
+      }
+    }
+  }
+
+  /**
+   * @brief      Same as @skim_unsafe, but the given function is called directly instead of through a std::function.
+   */
+  template<typename Do_for_each_synapse>
+  void skim_inline(Do_for_each_synapse&& do_for_each_synapse) const{
+    for(const Synapse_interval& interval : synapse_interval.get())
+      do_for_each_synapse(interval.starts(), interval.interval_size());
+  }
+
   /**
    * @brief      Direct access to an indvidual synapse index. Warning! very greedy!
    *             Instead of overflow it returns with 0 in case the given index is bigger, than the synapse size
@@ -165,6 +194,18 @@ public:
       else throw "Synapse index is not negative, as it should be, when queried for input index! ";
   }
 
+  /**
+   * @brief      Same as @input_index_from_synapse_index, but without checking the sign of the given index.
+   *             To be used only with synapses which are already verified.
+   *
+   * @param[in]  index  Synapse index, which is negative
+   *
+   * @return     Index in the input array based on the synapse input index
+   */
+  static uint32 input_index_from_synapse_index_unsafe(sint32 index){
+    return (static_cast<uint32>(index) * (-1) - 1);
+  }
+
 private:
   /**
    * The index of the first element in every synapse
@@ -0,0 +1,90 @@
+#ifndef WEIGHT_UPDATER_H
+#define WEIGHT_UPDATER_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+
+/**
+ * @brief      Updates the weights of a built @Solution in place from the weights of its @SparseNet, so a
+ *             weight change doesn't need the @Solution to be built again. Every weight of the @Partial_solution
+ *             elements is mapped back to the weight of the @SparseNet it is copied from, based on @weight_sources;
+ *             the slots every weight of the @SparseNet is copied into are collected in the constructor, so an update
+ *             takes time proportional to the number of changed weights. The weights are written in the format
+ *             of the @Partial_solution they are stored in. Memory filters changing to or from zero change
+ *             @neuron_memoryless as well, in which case the solvers of the @Solution shall refresh their Neurons.
+ *             Solvers with workers on more than one NUMA node read copies of the weights, which they shall refresh
+ *             after every update.
+ *             The referenced @Solution shall live as long as the updater does, and shall not be solved during an update.
+ */
+class Weight_updater{
+public:
+  /**
+   * @brief      Collects the weight slots of the given @Solution; throws in case any @Partial_solution
+   *             doesn't map its weights back to the @SparseNet
+   *
+   * @param      solution_  The solution to update
+   */
+  Weight_updater(Solution& solution_);
+
+  /**
+   * @brief      Copies every weight of the given @SparseNet into the @Solution; throws in case the weight table
+   *             of the net is smaller than the one the @Solution is built from.
+   *
+   * @param[in]  net   The net with the updated weights
+   *
+   * @return     True in case the classification of any Neuron changed between stateful and stateless,
+   *             so @Solution_solver::refresh_neurons shall be called
+   */
+  bool update(const SparseNet& net);
+
+  /**
+   * @brief      Copies the given weights of the @SparseNet into the @Solution; weights of the net not used
+   *             by the @Solution are ignored. Throws in case the sizes of the arguments don't match.
+   *
+   * @param[in]  weight_indices  The indices of the changed weights in the weight table of the @SparseNet
+   * @param[in]  weights         The new value of every changed weight
+   *
+   * @return     True in case the classification of any Neuron changed between stateful and stateless
+   */
+  bool update(const vector<uint32>& weight_indices, const vector<sdouble32>& weights);
+
+  /**
+   * @brief      Gets the number of weights of the @SparseNet the @Solution is mapped to
+   */
+  uint32 get_number_of_net_weights(void) const{
+    return net_weight_first_slot.size() - 1;
+  }
+
+private:
+  /**
+   * @brief      A weight inside a @Partial_solution
+   */
+  struct Weight_slot{
+    uint32 partial_index;
+    uint32 weight_index;
+    sint32 memory_filter_of; /* The Neuron inside the @Partial_solution whose memory filter the weight is, or -1 */
+  };
+
+  /**
+   * @brief      Writes a weight into its slot
+   *
+   * @return     True in case the Neuron, whose memory filter the weight is, changed between stateful and stateless
+   */
+  bool set_weight(const Weight_slot& slot, sdouble32 weight);
+
+  Solution& solution;
+  vector<uint32> net_weight_first_slot; /* The first slot of every weight of the @SparseNet in @weight_slots, and the number of slots at the end */
+  vector<Weight_slot> weight_slots; /* The slots of every weight of the @SparseNet, in the order of the net weights */
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* WEIGHT_UPDATER_H */
@@ -0,0 +1,141 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "sparse_net_global.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <condition_variable>
+#include <functional>
+
+#include "models/ring_buffer.h"
+#include "models/numa_topology.h"
+
+namespace sparse_net_library{
+
+using std::vector;
+using std::function;
+using std::unique_ptr;
+
+/**
+ * @brief      A fixed set of worker threads processing the tasks pushed into it, with work stealing.
+ *             The threads are started in the constructor and live until the pool is destroyed,
+ *             so the owner of the pool doesn't need to spawn or join any threads itself.
+ *             Destroying the pool waits for every already pushed task to finish.
+ *             Every task receives the index of the worker running it, so owners can keep
+ *             per-worker data without synchronization. Pushing a task allocates only if the task
+ *             doesn't fit into a std::function in itself, or a deque grows above its largest size so far.
+ *             Every worker has its own deque of tasks: tasks pushed by a task go into the deque of its worker,
+ *             which runs the latest of them first, while idle workers steal the oldest tasks from the deques
+ *             of the busy ones. Tasks pushed from outside the pool are distributed between the workers in turns.
+ *             In case a @Numa_topology is given, the workers are divided evenly between its nodes, and pinned
+ *             to the CPUs of their node. Tasks can be pushed to a node: they are queued to the workers of that node,
+ *             and idle workers steal from the workers of their own node first.
+ */
+class Worker_pool{
+public:
+  Worker_pool(uint16 number_of_workers, const Numa_topology* topology = nullptr);
+  ~Worker_pool();
+
+  /**
+   * @brief      Queues a task to be run by one of the workers. Called from a task of the pool,
+   *             the task is queued to the worker running it, regardless of the given node.
+   *
+   * @param[in]  task  The task to run, taking the index of the worker running it
+   * @param[in]  node  The node whose workers shall preferably run the task
+   */
+  void push(function<void(uint16)> task, uint16 node = 0);
+
+  /**
+   * @brief      Runs the given task for every element in the given range split into continuous chunks,
+   *             at most one for every worker, and waits for all of them to finish. In case any of the chunks throw,
+   *             the first exception is rethrown after every chunk is finished.
+   *             Shall not be called from a task of the same pool, because it blocks the calling thread.
+   *
+   * @param[in]  number_of_elements  The size of the range
+   * @param[in]  task                The task to run for every chunk, taking the index of the chunk,
+   *                                 which is below the number of workers, and the start and the end of the chunk
+   */
+  void run_in_chunks(uint32 number_of_elements, function<void(uint16, uint32, uint32)> task);
+
+  /**
+   * @brief      Gets the number of worker threads in the pool
+   *
+   * @return     The number of workers.
+   */
+  uint16 get_number_of_workers() const{
+    return workers.size();
+  }
+
+  /**
+   * @brief      Gets the number of nodes the workers are divided into; 1 without a @Numa_topology.
+   *             Nodes above the number of workers are not used.
+   */
+  uint16 get_number_of_nodes() const{
+    return node_first_worker.size() - 1;
+  }
+
+  /**
+   * @brief      Gets the node of the given worker
+   */
+  uint16 get_worker_node(uint16 worker_index) const{
+    return worker_node[worker_index];
+  }
+
+  /**
+   * @brief      Gets the number of tasks run by a different worker than the one they were queued to so far
+   */
+  uint64 get_number_of_stolen_tasks() const{
+    return stolen_tasks;
+  }
+
+private:
+  /**
+   * @brief      The tasks queued to a worker; the worker takes them from the back, thieves from the front
+   */
+  struct Worker_deque{
+    std::mutex mutex;
+    Ring_buffer<function<void(uint16)>> tasks;
+  };
+
+  /**
+   * @brief      Queues a task into the deque of the given worker, and wakes up an idle worker to take it,
+   *             preferably one of the node of the given worker
+   */
+  void push_to_worker(function<void(uint16)> task, uint16 worker_index);
+
+  /**
+   * @brief      Takes a task from the back of the deque of the given worker, or in case it's empty,
+   *             steals one from the front of the deques of the other workers, those of the same node first.
+   *
+   * @return     True if a task is taken
+   */
+  bool take_task(uint16 worker_index, function<void(uint16)>& task);
+
+  /**
+   * @brief      The loop of a worker thread: takes the next task until the pool is destroyed
+   *
+   * @param[in]  worker_index  The index of the worker, given to every task it runs
+   */
+  void work(uint16 worker_index);
+
+  vector<std::thread> workers;
+  vector<uint16> worker_node;
+  vector<uint16> node_first_worker; /* The workers of every node are continuous; the last element is the number of workers */
+  vector<unique_ptr<Worker_deque>> deques;
+  std::atomic<uint32> queued_tasks; /* The number of tasks in all of the deques */
+  std::atomic<uint32> idle_workers;
+  std::atomic<uint32> next_worker; /* Tasks from outside the pool go to the workers in turns */
+  std::atomic<uint64> stolen_tasks;
+  vector<uint16> idle_workers_on_node;
+  std::mutex idle_mutex;
+  vector<std::condition_variable> node_tasks_queued;
+  bool stopping = false;
+};
+
+} /* namespace sparse_net_library */
+
+#endif /* WORKER_POOL_H */
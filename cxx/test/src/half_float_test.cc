@@ -0,0 +1,250 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <random>
+
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+#include "gen/sparse_net.pb.h"
+#include "models/half_float.h"
+#include "models/service_context.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/partial_solution_solver.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint16;
+using sparse_net_library::uint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Half_float;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Partial_solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::Partial_solution_solver;
+using sparse_net_library::weight_storages;
+using sparse_net_library::WEIGHT_STORAGE_DOUBLE;
+using sparse_net_library::WEIGHT_STORAGE_FP16;
+using sparse_net_library::WEIGHT_STORAGE_BF16;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+using sparse_net_library::Neuron;
+using sparse_net_library::transfer_functions;
+using sparse_net_library::TRANSFER_FUNCTION_IDENTITY;
+using sparse_net_library::TRANSFER_FUNCTION_SIGMOID;
+using sparse_net_library::TRANSFER_FUNCTION_TANH;
+using sparse_net_library::TRANSFER_FUNCTION_ELU;
+using sparse_net_library::TRANSFER_FUNCTION_SELU;
+using sparse_net_library::TRANSFER_FUNCTION_RELU;
+
+sdouble32 round_trip(weight_storages storage, sdouble32 value){
+  if(WEIGHT_STORAGE_BF16 == storage) return Half_float::to_double<WEIGHT_STORAGE_BF16>(Half_float::from_double(storage, value));
+  else return Half_float::to_double<WEIGHT_STORAGE_FP16>(Half_float::from_double(storage, value));
+}
+
+/*###############################################################################################
+ * Testing if numbers are converted into the 16 bit formats and back correctly
+ * - Numbers representable in the format shall be kept exactly
+ * - Other numbers shall be rounded to the nearest, ties to the even number
+ * - The relative error of normal numbers shall not exceed the precision of the format
+ * */
+TEST_CASE( "Converting weights into 16 bit formats", "[half-float]" ){
+  for(weight_storages storage : {WEIGHT_STORAGE_FP16, WEIGHT_STORAGE_BF16}){
+    for(sdouble32 value : {0.0, 1.0, -1.0, 0.5, -2.5, 0.15625, 1024.0, -0.0009765625})
+      CHECK( value == round_trip(storage, value) );
+    CHECK( std::isinf(round_trip(storage, std::numeric_limits<sdouble32>::infinity())) );
+    CHECK( std::isnan(round_trip(storage, std::numeric_limits<sdouble32>::quiet_NaN())) );
+    for(uint32 variant_iterator = 0; variant_iterator < 1000; ++variant_iterator){
+      const sdouble32 value = (static_cast<sdouble32>(rand()%20001) - 10000.0) / 997.0;
+      if(0.0 != value)
+        CHECK( std::abs(round_trip(storage, value) - value) <= (std::abs(value) * Half_float::get_relative_precision(storage)) );
+    }
+  }
+
+  /* Half precision */
+  CHECK( 65504.0 == round_trip(WEIGHT_STORAGE_FP16, 65504.0) ); /* the largest number */
+  CHECK( std::isinf(round_trip(WEIGHT_STORAGE_FP16, 70000.0)) );
+  CHECK( std::pow(2.0, -24.0) == round_trip(WEIGHT_STORAGE_FP16, std::pow(2.0, -24.0)) ); /* the smallest subnormal */
+  CHECK( (3.0 * std::pow(2.0, -24.0)) == round_trip(WEIGHT_STORAGE_FP16, 3.0 * std::pow(2.0, -24.0)) );
+  CHECK( 0.0 == round_trip(WEIGHT_STORAGE_FP16, std::pow(2.0, -26.0)) );
+  CHECK( 1.0 == round_trip(WEIGHT_STORAGE_FP16, 1.0 + std::pow(2.0, -11.0)) ); /* ties to even */
+  CHECK( (1.0 + std::pow(2.0, -9.0)) == round_trip(WEIGHT_STORAGE_FP16, 1.0 + 3.0 * std::pow(2.0, -11.0)) );
+  CHECK( 0x3C00u == Half_float::fp16_from_float(1.0f) );
+  CHECK( 0xC000u == Half_float::fp16_from_float(-2.0f) );
+
+  /* bfloat16 */
+  CHECK( 1.0e30 == Approx(round_trip(WEIGHT_STORAGE_BF16, 1.0e30)).epsilon(0.004) ); /* the range of a 32 bit float */
+  CHECK( 1.0 == round_trip(WEIGHT_STORAGE_BF16, 1.0 + std::pow(2.0, -8.0)) ); /* ties to even */
+  CHECK( (1.0 + std::pow(2.0, -6.0)) == round_trip(WEIGHT_STORAGE_BF16, 1.0 + 3.0 * std::pow(2.0, -8.0)) );
+  CHECK( 0x3F80u == Half_float::bf16_from_float(1.0f) );
+}
+
+/*###############################################################################################
+ * Testing if arrays of half precision numbers are converted the same way as single numbers,
+ * whether or not the CPU supports the F16C instructions; NaNs only need to stay NaNs
+ * */
+TEST_CASE( "Converting arrays of half precision numbers", "[half-float]" ){
+  INFO( "F16C support: " << Half_float::has_f16c() );
+  const uint32 number_of_halves = 0x10000u + 5u; /* Every 16 bit pattern, and a part of a block after them */
+  std::string table(number_of_halves * sizeof(uint16), '\0');
+  for(uint32 half_index = 0; half_index < number_of_halves; ++half_index){
+    table[2 * half_index] = static_cast<char>(half_index & 0xFFu);
+    table[2 * half_index + 1] = static_cast<char>((half_index >> 8) & 0xFFu);
+  }
+  vector<float> values(number_of_halves);
+  Half_float::fp16_to_floats(table.data(), number_of_halves, values.data());
+  uint32 number_of_wrong_values = 0;
+  for(uint32 half_index = 0; half_index < number_of_halves; ++half_index){
+    const float expected = Half_float::fp16_to_float(Half_float::get_half(table.data(), half_index));
+    if(std::isnan(expected)?(!std::isnan(values[half_index])):(expected != values[half_index])) ++number_of_wrong_values;
+  }
+  CHECK( 0 == number_of_wrong_values );
+
+  for(uint32 value_index = 0; value_index < number_of_halves; ++value_index) /* between the halves as well */
+    values[value_index] = static_cast<float>((static_cast<sdouble32>(rand()%2000001) - 1000000.0) / 997.0 * std::pow(2.0, (rand()%40) - 30));
+  std::string narrowed_table(number_of_halves * sizeof(uint16), '\0');
+  Half_float::fp16_from_floats(values.data(), number_of_halves, &narrowed_table[0]);
+  number_of_wrong_values = 0;
+  for(uint32 value_index = 0; value_index < number_of_halves; ++value_index)
+    if(Half_float::fp16_from_float(values[value_index]) != Half_float::get_half(narrowed_table.data(), value_index)) ++number_of_wrong_values;
+  CHECK( 0 == number_of_wrong_values );
+}
+
+/*###############################################################################################
+ * Testing if the weight table of a @Partial_solution is converted between the formats,
+ * and only the table of the format is accepted by the solver
+ * */
+TEST_CASE( "Storing the weights of a Partial solution in 16 bits", "[half-float]" ){
+  vector<uint32> net_structure = {5,3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(4).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> solution(Solution_builder().build(*net));
+  const Partial_solution original = solution->partial_solutions(0);
+
+  for(weight_storages storage : {WEIGHT_STORAGE_FP16, WEIGHT_STORAGE_BF16}){
+    Partial_solution partial = original;
+    Half_float::store_weight_table(partial, storage);
+    CHECK( storage == partial.weight_storage() );
+    CHECK( 0 == partial.weight_table_size() );
+    REQUIRE( (original.weight_table_size() * sizeof(uint16)) == partial.half_weight_table().size() );
+    CHECK_NOTHROW( Partial_solution_solver(partial) );
+
+    Half_float::store_weight_table(partial, WEIGHT_STORAGE_DOUBLE);
+    CHECK( WEIGHT_STORAGE_DOUBLE == partial.weight_storage() );
+    CHECK( partial.half_weight_table().empty() );
+    REQUIRE( original.weight_table_size() == partial.weight_table_size() );
+    for(int weight_index = 0; weight_index < original.weight_table_size(); ++weight_index)
+      CHECK( round_trip(storage, original.weight_table(weight_index)) == partial.weight_table(weight_index) );
+  }
+
+  Partial_solution both_tables = original;
+  both_tables.set_half_weight_table(std::string(original.weight_table_size() * sizeof(uint16), '\0'));
+  CHECK_THROWS( Partial_solution_solver(both_tables) );
+  both_tables.set_weight_storage(WEIGHT_STORAGE_FP16);
+  CHECK_THROWS( Partial_solution_solver(both_tables) );
+  both_tables.clear_weight_table();
+  CHECK_NOTHROW( Partial_solution_solver(both_tables) );
+  both_tables.set_half_weight_table(std::string(original.weight_table_size() * sizeof(uint16) - 1, '\0'));
+  CHECK_THROWS( Partial_solution_solver(both_tables) ); /* Odd number of bytes */
+  both_tables.set_half_weight_table(std::string((original.weight_table_size() - 1) * sizeof(uint16), '\0'));
+  CHECK_THROWS( Partial_solution_solver(both_tables) ); /* Weights missing */
+  CHECK_THROWS( Half_float::store_weight_table(both_tables, static_cast<weight_storages>(100)) );
+}
+
+/*###############################################################################################
+ * Measuring the accuracy lost by storing the weights in 16 bits:
+ * - A @Solution is built in every format from the same @SparseNet
+ * - The outputs are compared to the outputs of the double precision weights for consecutive inputs,
+ *   so the Neuron memory is involved as well
+ * - Single inputs, batches and checked solving shall all give the same results with the 16 bit weights
+ * - The weights, transfer functions and inputs come from a generator with a fixed seed,
+ *   so the measured errors don't depend on which tests ran before
+ * */
+void randomize_net(SparseNet& net, std::mt19937& generator){
+  const vector<transfer_functions> functions = {
+    TRANSFER_FUNCTION_IDENTITY, TRANSFER_FUNCTION_SIGMOID, TRANSFER_FUNCTION_TANH,
+    TRANSFER_FUNCTION_ELU, TRANSFER_FUNCTION_SELU, TRANSFER_FUNCTION_RELU
+  };
+  std::uniform_int_distribution<uint32> function_distribution(0, functions.size() - 1);
+  std::uniform_real_distribution<sdouble32> unit_distribution(-1.0, 1.0);
+  std::uniform_real_distribution<sdouble32> memory_distribution(0.0, 1.0);
+  for(Neuron& neuron : *net.mutable_neuron_array()){
+    neuron.set_transfer_function_idx(functions[function_distribution(generator)]);
+    net.set_weight_table(neuron.bias_idx(), unit_distribution(generator));
+    net.set_weight_table(neuron.memory_filter_idx(), memory_distribution(generator));
+    for(const sparse_net_library::Synapse_interval& weight_synapse : neuron.input_weights()){
+      const sdouble32 amplitude = std::sqrt(2.0 / static_cast<sdouble32>(weight_synapse.interval_size()));
+      for(uint32 weight_index = 0; weight_index < weight_synapse.interval_size(); ++weight_index)
+        net.set_weight_table(weight_synapse.starts() + weight_index, amplitude * unit_distribution(generator));
+    }
+  }
+}
+
+sdouble32 measure_weight_storage_error(weight_storages storage, const SparseNet& net, sdouble32 device_max_megabytes, uint32 seed){
+  unique_ptr<Solution> reference_solution(Solution_builder().max_solve_threads(4).device_max_megabytes(device_max_megabytes).build(net));
+  unique_ptr<Solution> solution(
+    Solution_builder().max_solve_threads(4).device_max_megabytes(device_max_megabytes).weight_storage(storage).build(net)
+  );
+  REQUIRE( reference_solution->partial_solutions_size() == solution->partial_solutions_size() );
+  for(const Partial_solution& partial : solution->partial_solutions())
+    REQUIRE( storage == partial.weight_storage() );
+
+  Solution_solver reference_solver(*reference_solution);
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  Solution_solver checked_solver(*solution, Service_context().set_checked_solve(true));
+  Solution_solver batch_solver(*solution);
+  sdouble32 max_error = 0.0;
+  std::mt19937 generator(seed); /* The same inputs for every storage */
+  std::uniform_int_distribution<uint32> input_distribution(0, 99);
+  vector<sdouble32> network_inputs(net.input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(input_distribution(generator)) / 10.0;
+    vector<sdouble32> reference_output = reference_solver.solve(network_inputs);
+    vector<sdouble32> output = solver.solve(network_inputs);
+    vector<sdouble32> checked_output = checked_solver.solve(network_inputs);
+    vector<sdouble32> batch_output = batch_solver.solve_batch(network_inputs, 1);
+    REQUIRE( reference_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator){
+      CHECK( Approx(output[output_iterator]).epsilon(0.00000000000001) == checked_output[output_iterator] );
+      CHECK( Approx(output[output_iterator]).epsilon(0.00000000000001) == batch_output[output_iterator] );
+      max_error = std::max(max_error, std::abs(reference_output[output_iterator] - output[output_iterator]));
+    }
+  }
+  return max_error;
+}
+
+TEST_CASE( "Solving with weights stored in 16 bits", "[solve][half-float]" ){
+  vector<uint32> net_structure = {40,30,20,5};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(10).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  const uint32 seed = 1;
+  std::mt19937 generator(seed);
+  randomize_net(*net, generator);
+  unique_ptr<Solution> solution(Solution_builder().build(*net));
+  const sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+
+  const sdouble32 fp16_error = measure_weight_storage_error(WEIGHT_STORAGE_FP16, *net, solution_size / 4.0, seed);
+  const sdouble32 bf16_error = measure_weight_storage_error(WEIGHT_STORAGE_BF16, *net, solution_size / 4.0, seed);
+  INFO( "Largest output error with fp16 weights: " << fp16_error << "; with bf16 weights: " << bf16_error );
+  CHECK( 0.01 > fp16_error ); /* About 0.002 with this seed, and below that with the others tried */
+  CHECK( 0.1 > bf16_error );
+  CHECK( fp16_error <= bf16_error ); /* bfloat16 has less mantissa bits */
+  CHECK( 0.0 == measure_weight_storage_error(WEIGHT_STORAGE_DOUBLE, *net, solution_size / 4.0, seed) );
+}
+
+} /* namespace sparse_net_library_test */
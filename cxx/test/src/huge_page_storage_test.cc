@@ -0,0 +1,111 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <google/protobuf/arena.h>
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+#include "models/service_context.h"
+#include "models/huge_page_storage.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint64;
+using sparse_net_library::uint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Huge_page_storage;
+using sparse_net_library::Huge_page_allocator;
+using sparse_net_library::Page_backing;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if buffers allocated through the @Huge_page_storage are usable whichever pages
+ * they end up stored in, and only buffers of at least a huge page are attempted to be stored in huge pages
+ * - Buffers are only reported in transparent huge pages when the kernel backs them with huge pages
+ * */
+TEST_CASE( "Storing buffers in huge pages", "[memory][huge-pages]" ){
+  const uint32 elements_in_huge_page = Huge_page_storage::huge_page_bytes / sizeof(sdouble32);
+
+  Huge_page_allocator<sdouble32> regular_allocator(false);
+  vector<sdouble32, Huge_page_allocator<sdouble32>> regular_buffer(2 * elements_in_huge_page, 1.0, regular_allocator);
+  CHECK( Page_backing::regular_pages == regular_allocator.get_backing() );
+
+  Huge_page_allocator<sdouble32> small_allocator(true);
+  vector<sdouble32, Huge_page_allocator<sdouble32>> small_buffer(elements_in_huge_page / 2, 1.0, small_allocator);
+  CHECK( Page_backing::regular_pages == small_allocator.get_backing() );
+
+  Huge_page_allocator<sdouble32> huge_allocator(true);
+  vector<sdouble32, Huge_page_allocator<sdouble32>> huge_buffer(huge_allocator);
+  huge_buffer.resize(2 * elements_in_huge_page + 3, 2.0); /* The pages depend on the system, but the data shall be usable either way */
+  for(uint32 element_iterator = 0; element_iterator < huge_buffer.size(); element_iterator += 1024)
+    huge_buffer[element_iterator] += regular_buffer[element_iterator % regular_buffer.size()];
+  uint32 number_of_wrong_elements = 0;
+  for(uint32 element_iterator = 0; element_iterator < huge_buffer.size(); ++element_iterator)
+    if(((0 == (element_iterator % 1024))?(3.0):(2.0)) != huge_buffer[element_iterator]) ++number_of_wrong_elements;
+  CHECK( 0 == number_of_wrong_elements );
+  INFO( "Huge buffer backing: " << static_cast<uint32>(huge_allocator.get_backing()) );
+  if(Page_backing::regular_pages != huge_allocator.get_backing()) /* Only a mapping aligned to huge pages can be backed by them */
+    CHECK( 0 == (reinterpret_cast<std::uintptr_t>(huge_buffer.data()) % Huge_page_storage::huge_page_bytes) );
+  if(Page_backing::transparent_huge_pages == huge_allocator.get_backing())
+    CHECK( huge_buffer.size() * sizeof(sdouble32) <= Huge_page_storage::get_transparent_huge_page_bytes(huge_buffer.data(), huge_buffer.size() * sizeof(sdouble32)) );
+
+  /* Arena blocks are reported while they are in huge pages */
+  const uint64 arena_bytes_before = Huge_page_storage::get_arena_bytes_in_huge_pages();
+  {
+    google::protobuf::Arena arena(Huge_page_storage::arena_options());
+    Solution* solution = google::protobuf::Arena::CreateMessage<Solution>(&arena);
+    solution->set_neuron_number(5);
+    CHECK( 5 == solution->neuron_number() );
+    CHECK( Huge_page_storage::huge_page_bytes <= arena.SpaceAllocated() );
+  }
+  CHECK( arena_bytes_before == Huge_page_storage::get_arena_bytes_in_huge_pages() );
+}
+
+/*###############################################################################################
+ * Testing if a @Solution_solver gives the same results with its buffers and the weights of the
+ * @Solution stored in huge pages, and it reports the pages of its Neuron data
+ * */
+TEST_CASE( "Solving a Solution stored in huge pages", "[solve][huge-pages]" ){
+  vector<uint32> net_structure = {20,10,30,10,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(50).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+
+  google::protobuf::Arena arena(Huge_page_storage::arena_options());
+  Solution* huge_solution = Solution_builder().max_solve_threads(4).device_max_megabytes(2048.0).arena_ptr(&arena).build(*net);
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(4).device_max_megabytes(2048.0).build(*net));
+
+  Solution_solver huge_solver(*huge_solution, Service_context().set_max_solve_threads(4).set_huge_page_storage(true));
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  vector<sdouble32> network_inputs(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = solver.solve(network_inputs);
+    vector<sdouble32> output = huge_solver.solve(network_inputs);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+
+  /* The Neuron data of such a small network doesn't fill a huge page */
+  CHECK( Page_backing::regular_pages == huge_solver.get_neuron_data_backing() );
+  CHECK( Page_backing::regular_pages == solver.get_neuron_data_backing() );
+}
+
+} /* namespace sparse_net_library_test */
@@ -2,6 +2,9 @@
 
 #include "test/catch.hpp"
 
+#include <cstdlib>
+#include <new>
+
 #include "test/test_mockups.h"
 #include "models/transfer_function.h"
 #include "services/synapse_iterator.h"
@@ -140,5 +143,22 @@ void manaual_fully_connected_network_result(vector<sdouble32> inputs, vector<sdo
   } /* For every Neuron */
 }
 
+std::atomic<bool> counting_allocations(false);
+std::atomic<uint64> number_of_allocations(0);
 
 } /* namsepace sparse_net_library_test */
+
+void* operator new(std::size_t size){
+  if(sparse_net_library_test::counting_allocations) ++sparse_net_library_test::number_of_allocations;
+  void* memory = std::malloc((0 < size)?(size):(1));
+  if(nullptr == memory) throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void* memory) noexcept{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept{
+  std::free(memory);
+}
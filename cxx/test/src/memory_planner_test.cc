@@ -0,0 +1,262 @@
+#include "test/catch.hpp"
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/memory_planner.h"
+
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint32;
+using sparse_net_library::sint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Partial_solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::Memory_planner;
+using sparse_net_library::Synapse_interval;
+using sparse_net_library::Synapse_iterator;
+using sparse_net_library::Service_context;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if the @Memory_planner reuses the slots of Neurons no longer needed,
+ * without any two Neurons needed at the same time sharing a slot
+ * */
+TEST_CASE( "Planning the Neuron data of a Solution", "[solve][memory]" ){
+  vector<uint32> net_structure = {20,10,30,10,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(50).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+
+  unique_ptr<Solution> whole_solution(Solution_builder().max_solve_threads(4).device_max_megabytes(2048.0).build(*net));
+  sdouble32 space_used_megabytes = whole_solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(4).device_max_megabytes(space_used_megabytes/5.0).build(*net));
+  REQUIRE( 2 < solution->cols_size() );
+
+  Memory_planner plan(*solution);
+  CHECK( plan.get_neuron_data_size() < solution->neuron_number() );
+
+  /* The output slots follow the order of the output Neurons */
+  uint32 output_iterator = solution->neuron_number() - solution->output_neuron_number();
+  REQUIRE( solution->output_neuron_number() == Synapse_iterator(plan.get_output_slots()).size() );
+  Synapse_iterator(plan.get_output_slots()).iterate([&](int slot){
+    CHECK( static_cast<sint32>(plan.get_slot(output_iterator)) == slot );
+    ++output_iterator;
+  });
+
+  /* Collect the lifetime of every Neuron: the inputs of a row are gathered before it is solved,
+   * so a Neuron needs its slot from the row calculating it until the row before the one reading it last
+   * */
+  vector<sint32> produced_in_row(solution->neuron_number(), -1);
+  vector<sint32> last_used_in_row(solution->neuron_number(), -1);
+  int partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution->cols_size(); ++row_iterator){
+    for(uint32 col_iterator = 0; col_iterator < solution->cols(row_iterator); ++col_iterator){
+      const Partial_solution& partial = solution->partial_solutions(partial_iterator);
+      Synapse_iterator(partial.output_data()).iterate([&](int neuron_index){
+        produced_in_row[neuron_index] = row_iterator;
+        last_used_in_row[neuron_index] = std::max(last_used_in_row[neuron_index], row_iterator);
+      });
+      Synapse_iterator(partial.input_data()).iterate([&](int neuron_index){
+        if(!Synapse_iterator::is_index_input(neuron_index))
+          last_used_in_row[neuron_index] = std::max(last_used_in_row[neuron_index], row_iterator - 1);
+      });
+      ++partial_iterator;
+    }
+  }
+  for(uint32 neuron_index = (solution->neuron_number() - solution->output_neuron_number()); neuron_index < solution->neuron_number(); ++neuron_index)
+    last_used_in_row[neuron_index] = solution->cols_size();
+
+  /* Neurons alive in the same row shall not share a slot */
+  for(int row_iterator = 0; row_iterator < solution->cols_size(); ++row_iterator){
+    vector<sint32> slot_owner(plan.get_neuron_data_size(), -1);
+    for(uint32 neuron_index = 0; neuron_index < solution->neuron_number(); ++neuron_index){
+      if((produced_in_row[neuron_index] <= row_iterator)&&(row_iterator <= last_used_in_row[neuron_index])){
+        REQUIRE( plan.get_neuron_data_size() > plan.get_slot(neuron_index) );
+        CHECK( -1 == slot_owner[plan.get_slot(neuron_index)] );
+        slot_owner[plan.get_slot(neuron_index)] = neuron_index;
+      }
+    }
+  }
+
+  /* The input of every row contains the inputs of its @Partial_solution elements */
+  partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution->cols_size(); ++row_iterator){
+    vector<sint32> row_input;
+    Synapse_iterator(plan.get_row_inputs(row_iterator)).iterate([&](int index){
+      row_input.push_back(index);
+    });
+    CHECK( plan.get_max_row_input_size() >= row_input.size() );
+    for(uint32 col_iterator = 0; col_iterator < solution->cols(row_iterator); ++col_iterator){
+      Synapse_iterator(plan.get_partial_inputs(partial_iterator)).iterate([&](int index){
+        CHECK( row_input.end() != std::find(row_input.begin(), row_input.end(), index) );
+      });
+      ++partial_iterator;
+    }
+  }
+
+  /* The mapped inputs and outputs point to the slots of the original Neurons */
+  for(partial_iterator = 0; partial_iterator < solution->partial_solutions_size(); ++partial_iterator){
+    const Partial_solution& partial = solution->partial_solutions(partial_iterator);
+    Synapse_iterator mapped_inputs(plan.get_partial_inputs(partial_iterator));
+    Synapse_iterator mapped_outputs(plan.get_partial_outputs(partial_iterator));
+    uint32 element_iterator = 0;
+    REQUIRE( Synapse_iterator(partial.input_data()).size() == mapped_inputs.size() );
+    Synapse_iterator(partial.input_data()).iterate([&](int index){
+      if(Synapse_iterator::is_index_input(index)) CHECK( index == mapped_inputs[element_iterator] );
+        else CHECK( static_cast<sint32>(plan.get_slot(index)) == mapped_inputs[element_iterator] );
+      ++element_iterator;
+    });
+    element_iterator = 0;
+    REQUIRE( Synapse_iterator(partial.output_data()).size() == mapped_outputs.size() );
+    Synapse_iterator(partial.output_data()).iterate([&](int index){
+      CHECK( static_cast<sint32>(plan.get_slot(index)) == mapped_outputs[element_iterator] );
+      ++element_iterator;
+    });
+  }
+
+  /* Solving the divided Solution gives the same result as the undivided one */
+  Solution_solver whole_solver(*whole_solution);
+  Solution_solver solver(*solution);
+  vector<sdouble32> network_inputs(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = whole_solver.solve(network_inputs);
+    vector<sdouble32> output = solver.solve(network_inputs);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+}
+
+/*###############################################################################################
+ * Testing if the @Memory_planner places the outputs of every @Partial_solution into separate cache lines
+ * when it is given an alignment of a cache line
+ * */
+TEST_CASE( "Planning the Neuron data of a Solution into cache lines", "[solve][memory]" ){
+  const uint32 slots_in_cache_line = sparse_net_library::cache_line_bytes / sizeof(sdouble32);
+  vector<uint32> net_structure = {20,10,30,10,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(50).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+
+  unique_ptr<Solution> whole_solution(Solution_builder().max_solve_threads(4).device_max_megabytes(2048.0).build(*net));
+  sdouble32 space_used_megabytes = whole_solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(4).device_max_megabytes(space_used_megabytes/5.0).build(*net));
+
+  Memory_planner plan(*solution, slots_in_cache_line);
+  CHECK( 0 == (plan.get_neuron_data_size() % slots_in_cache_line) );
+
+  /* The outputs of every partial are in one aligned range, in cache lines not written by any other partial of the same row */
+  int partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution->cols_size(); ++row_iterator){
+    vector<sint32> cache_line_owner(plan.get_neuron_data_size() / slots_in_cache_line, -1);
+    for(uint32 col_iterator = 0; col_iterator < solution->cols(row_iterator); ++col_iterator){
+      REQUIRE( 1 == plan.get_partial_outputs(partial_iterator).size() );
+      CHECK( 0 == (plan.get_partial_outputs(partial_iterator).Get(0).starts() % slots_in_cache_line) );
+      Synapse_iterator(plan.get_partial_outputs(partial_iterator)).iterate([&](int slot){
+        REQUIRE( plan.get_neuron_data_size() > static_cast<uint32>(slot) );
+        const uint32 cache_line = slot / slots_in_cache_line;
+        CHECK( ((-1 == cache_line_owner[cache_line])||(partial_iterator == cache_line_owner[cache_line])) );
+        cache_line_owner[cache_line] = partial_iterator;
+      });
+      ++partial_iterator;
+    }
+  }
+
+  /* Solving with aligned partials gives the same result as without */
+  Solution_solver aligned_solver(*solution, Service_context().set_max_solve_threads(4));
+  Solution_solver packed_solver(*solution, Service_context().set_max_solve_threads(4).set_cache_aligned_partials(false));
+  vector<sdouble32> network_inputs(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = packed_solver.solve(network_inputs);
+    vector<sdouble32> output = aligned_solver.solve(network_inputs);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+}
+
+/*###############################################################################################
+ * Microbenchmark of the contention between threads writing the outputs of neighbouring partials:
+ * one thread writes the outputs of every partial of the widest row, into the slots planned
+ * with and without cache line alignment. Hidden by default, run it with the [benchmark] tag.
+ * Each write shall land in the slot of its own partial, and with the alignment no cache line shall be shared.
+ * */
+TEST_CASE( "Benchmarking the cache line contention of the Neuron data", "[.][benchmark]" ){
+  vector<uint32> net_structure = {64,64,64,64,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(64).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> whole_solution(Solution_builder().max_solve_threads(4).device_max_megabytes(2048.0).build(*net));
+  sdouble32 space_used_megabytes = whole_solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(4).device_max_megabytes(space_used_megabytes/20.0).build(*net));
+
+  uint32 widest_row = 0;
+  uint32 first_partial_of_widest_row = 0;
+  uint32 partial_iterator = 0;
+  for(int row_iterator = 0; row_iterator < solution->cols_size(); ++row_iterator){
+    if(solution->cols(widest_row) < solution->cols(row_iterator)){
+      widest_row = row_iterator;
+      first_partial_of_widest_row = partial_iterator;
+    }
+    partial_iterator += solution->cols(row_iterator);
+  }
+  REQUIRE( 1 < solution->cols(widest_row) );
+
+  const uint32 number_of_writes = 200000;
+  for(uint32 slot_alignment : {1u, static_cast<uint32>(sparse_net_library::cache_line_bytes / sizeof(sdouble32))}){
+    Memory_planner plan(*solution, slot_alignment);
+    vector<sdouble32, sparse_net_library::Aligned_allocator<sdouble32>> neuron_data(plan.get_neuron_data_size());
+    vector<std::thread> writers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(uint32 col_iterator = 0; col_iterator < solution->cols(widest_row); ++col_iterator){
+      writers.push_back(std::thread([&plan, &neuron_data, partial_index = first_partial_of_widest_row + col_iterator](){
+        for(uint32 write_iterator = 0; write_iterator < number_of_writes; ++write_iterator){
+          Synapse_iterator(plan.get_partial_outputs(partial_index)).iterate_inline([&](int slot){
+            neuron_data[slot] = neuron_data[slot] + 1.0;
+          });
+        }
+      }));
+    }
+    for(std::thread& writer : writers) writer.join();
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    WARN(
+      "Writing the outputs of " << solution->cols(widest_row) << " partials with slot alignment " << slot_alignment << ": "
+      << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us"
+    );
+
+    /* Every slot has a single writer, so no write shall be lost, and aligned partials shall not share cache lines */
+    vector<int> writer_of_line(neuron_data.size() / slot_alignment + 1, -1);
+    for(uint32 col_iterator = 0; col_iterator < solution->cols(widest_row); ++col_iterator){
+      Synapse_iterator(plan.get_partial_outputs(first_partial_of_widest_row + col_iterator)).iterate_inline([&](int slot){
+        CHECK( static_cast<sdouble32>(number_of_writes) == neuron_data[slot] );
+        if(1u < slot_alignment){
+          int& writer = writer_of_line[slot / slot_alignment];
+          CHECK( ((-1 == writer)||(static_cast<int>(col_iterator) == writer)) );
+          writer = col_iterator;
+        }
+      });
+    }
+  }
+}
+
+} /* namespace sparse_net_library_test */
@@ -0,0 +1,139 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+#include "models/service_context.h"
+#include "models/numa_topology.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/worker_pool.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint16;
+using sparse_net_library::uint32;
+using sparse_net_library::uint64;
+using sparse_net_library::sint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Numa_topology;
+using sparse_net_library::Worker_pool;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if the detected topology describes every node with its CPUs, and if a @Worker_pool
+ * divides its workers between the nodes of a simulated topology, running every task pushed to any node
+ * */
+TEST_CASE( "Distributing workers between NUMA nodes", "[numa]" ){
+  unique_ptr<Numa_topology> detected_topology = Numa_topology::detect();
+  REQUIRE( 0 < detected_topology->get_number_of_nodes() );
+  for(uint16 node_iterator = 0; node_iterator < detected_topology->get_number_of_nodes(); ++node_iterator)
+    CHECK( 0 < detected_topology->get_node_cpus(node_iterator).size() );
+  CHECK_FALSE( detected_topology->is_simulated() );
+  CHECK_THROWS( Numa_topology(vector<vector<uint32>>()) );
+
+  /* Both simulated nodes use the CPUs of the first detected node, so it runs on any machine */
+  const vector<uint32>& cpus = detected_topology->get_node_cpus(0);
+  Numa_topology topology({cpus, cpus});
+  CHECK( topology.is_simulated() );
+
+  Worker_pool workers(4, &topology);
+  REQUIRE( 2 == workers.get_number_of_nodes() );
+  CHECK( 0 == workers.get_worker_node(0) );
+  CHECK( 0 == workers.get_worker_node(1) );
+  CHECK( 1 == workers.get_worker_node(2) );
+  CHECK( 1 == workers.get_worker_node(3) );
+
+  const uint32 number_of_tasks = 1000;
+  std::atomic<uint32> tasks_done(0);
+  std::mutex done_mutex;
+  std::condition_variable done_changed;
+  for(uint32 task_iterator = 0; task_iterator < number_of_tasks; ++task_iterator){
+    workers.push([&](uint16){
+      if(number_of_tasks == ++tasks_done){
+        std::lock_guard<std::mutex> my_lock(done_mutex);
+        done_changed.notify_one();
+      }
+    }, task_iterator % 2);
+  }
+  std::unique_lock<std::mutex> my_lock(done_mutex);
+  done_changed.wait(my_lock, [&](){ return number_of_tasks == tasks_done; });
+  CHECK( number_of_tasks == tasks_done );
+}
+
+/*###############################################################################################
+ * Testing if a @Solution_solver on a simulated topology gives the same results as one without,
+ * while placing the weights and Neuron data of its partial solutions onto both nodes
+ * - The weights are read from copies on the nodes, which are updated by refreshing the weights
+ * */
+TEST_CASE( "Solving a Solution on NUMA nodes", "[solve][numa]" ){
+  vector<uint32> net_structure = {20,10,30,10,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(50).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(4).device_max_megabytes(0.01).build(*net));
+  REQUIRE( 1 < solution->cols(0) ); /* So the partial solutions of a row are divided between the nodes */
+
+  const vector<uint32> cpus = Numa_topology::detect()->get_node_cpus(0);
+  Numa_topology topology({cpus, cpus});
+  Solution_solver numa_solver(*solution, Service_context().set_max_solve_threads(4).set_numa_topology(&topology));
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  const Solution original_solution = *solution;
+  Solution_solver original_solver(original_solution, Service_context().set_max_solve_threads(4));
+
+  uint64 weight_bytes = 0;
+  for(sint32 partial_iterator = 0; partial_iterator < solution->partial_solutions_size(); ++partial_iterator)
+    weight_bytes += solution->partial_solutions(partial_iterator).weight_table_size() * sizeof(sdouble32);
+  const uint64 placed_weight_bytes = topology.get_placed_bytes(0) + topology.get_placed_bytes(1);
+  CHECK( weight_bytes == placed_weight_bytes );
+
+  vector<sdouble32> network_inputs(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = solver.solve(network_inputs);
+    vector<sdouble32> output = numa_solver.solve(network_inputs);
+    original_solver.solve(network_inputs); /* So its Neuron memory follows the others */
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+
+  /* Every Neuron is placed with the outputs of its partial solution */
+  CHECK( (placed_weight_bytes + solution->neuron_number() * sizeof(sdouble32))
+    == (topology.get_placed_bytes(0) + topology.get_placed_bytes(1)) );
+  CHECK( 0 < topology.get_placed_bytes(0) );
+  CHECK( 0 < topology.get_placed_bytes(1) );
+
+  /* The solver on both nodes reads its own copy of the weights, until it is refreshed */
+  for(sint32 partial_iterator = 0; partial_iterator < solution->partial_solutions_size(); ++partial_iterator)
+    for(sdouble32& weight : *solution->mutable_partial_solutions(partial_iterator)->mutable_weight_table()) weight = 0.0;
+  for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+  vector<sdouble32> expected_output = solver.solve(network_inputs);
+  vector<sdouble32> original_output = original_solver.solve(network_inputs);
+  vector<sdouble32> output = numa_solver.solve(network_inputs);
+  for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+    CHECK( Approx(original_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  numa_solver.refresh_weights(); /* Without any weight, the outputs don't depend on the inputs or the memory */
+  output = numa_solver.solve(network_inputs);
+  for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+    CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+}
+
+} /* namespace sparse_net_library_test */
@@ -1,4 +1,6 @@
 #include <random>
+#include <limits>
+#include <memory>
 
 #include "test/catch.hpp"
 #include "test/test_mockups.h"
@@ -18,6 +20,7 @@ using sparse_net_library::sdouble32;
 using sparse_net_library::uint8;
 using sparse_net_library::uint16;
 using sparse_net_library::uint32;
+using sparse_net_library::sint32;
 using sparse_net_library::transfer_functions;
 using sparse_net_library::TRANSFER_FUNCTION_IDENTITY;
 using sparse_net_library::Partial_solution;
@@ -25,6 +28,8 @@ using sparse_net_library::Partial_solution_solver;
 using sparse_net_library::Transfer_function;
 using sparse_net_library::Synapse_iterator;
 using sparse_net_library::Synapse_interval;
+using sparse_net_library::Input_transform;
+using google::protobuf::RepeatedPtrField;
 
 /*###############################################################################################
  * Testing if the solver processes a partial_solution detail correctly
@@ -104,6 +109,7 @@ TEST_CASE( "Solving an artificial partial_solution detail", "[solve][partial_sol
  * - define different partition ranges based on it
  * - define the partial solution so every neuon gives back the corresponding input
  * - see if the input is collected correctly
+ * - see if the input is preprocessed correctly while collected
  */
 TEST_CASE("Test Partial solution input collection","[solve][partial_solution][input_collection]"){
   Partial_solution partial_solution;
@@ -164,6 +170,335 @@ TEST_CASE("Test Partial solution input collection","[solve][partial_solution][in
   for(uint32 i = 0; i < network_inputs.size(); ++i){
     REQUIRE( network_inputs[i] == collected_inputs[i]);
   }
+
+  /* The inputs shall be preprocessed while they are collected, in batches as well */
+  RepeatedPtrField<Input_transform> input_transforms;
+  for(uint32 i = 0; i < network_inputs.size(); ++i){
+    Input_transform& transform = *input_transforms.Add();
+    transform.set_scale(0.5);
+    transform.set_offset(static_cast<sdouble32>(i) - 4.0);
+    transform.set_min_value(0.0);
+    transform.set_max_value((0 == (i % 2))?(std::numeric_limits<sdouble32>::infinity()):(3.0));
+  }
+  auto transformed = [&input_transforms](uint32 input_index, sdouble32 input){
+    const Input_transform& transform = input_transforms.Get(input_index);
+    return std::min(std::max(input * transform.scale() + transform.offset(), transform.min_value()), transform.max_value());
+  };
+  solver.set_input_transforms(input_transforms);
+  solver.collect_input_data(network_inputs,{});
+  collected_inputs = solver.solve();
+  for(uint32 i = 0; i < network_inputs.size(); ++i)
+    CHECK( transformed(i, network_inputs[i]) == collected_inputs[i] );
+  const uint32 batch_size = 3;
+  vector<sdouble32> batch_inputs(network_inputs.size() * batch_size);
+  for(uint32 lane_iterator = 0; lane_iterator < batch_inputs.size(); ++lane_iterator)
+    batch_inputs[lane_iterator] = static_cast<sdouble32>(rand()%100) / 10.0;
+  collected_inputs = vector<sdouble32>(batch_inputs.size());
+  solver.collect_batch_input_data(batch_inputs, {}, collected_inputs, batch_size);
+  for(uint32 lane_iterator = 0; lane_iterator < batch_inputs.size(); ++lane_iterator)
+    CHECK( transformed(lane_iterator / batch_size, batch_inputs[lane_iterator]) == collected_inputs[lane_iterator] );
+
+  input_transforms.RemoveLast(); /* The last input has no transformation */
+  CHECK_THROWS( solver.set_input_transforms(input_transforms) );
+  *input_transforms.Add() = input_transforms.Get(0);
+  input_transforms.Mutable(3)->set_min_value(5.0); /* Clipped into an empty range */
+  CHECK_THROWS( solver.set_input_transforms(input_transforms) );
+  solver.set_input_transforms(RepeatedPtrField<Input_transform>());
+  solver.collect_input_data(network_inputs,{});
+  collected_inputs = solver.solve();
+  for(uint32 i = 0; i < network_inputs.size(); ++i)
+    CHECK( network_inputs[i] == collected_inputs[i]);
+}
+
+/*###############################################################################################
+ * Testing if the structure of a partial solution is verified correctly
+ * - A correct partial solution shall be accepted
+ * - Neurons taking inputs from themselves, or from out of bounds shall be rejected
+ * - Neurons with mismatching number of inputs and weights shall be rejected
+ * - In checked mode, incorrectly sized solver inputs shall be detected while solving
+ */
+TEST_CASE("Partial solution structure verification","[solve][partial_solution][verification]"){
+  vector<sdouble32> network_inputs = {10.0,5.0,3.0};
+  Synapse_interval temp_synapse_interval;
+  Partial_solution partial_solution;
+  manual_2_neuron_partial_solution(partial_solution, network_inputs.size());
+  temp_synapse_interval.set_starts(Synapse_iterator::synapse_index_from_input_index(0));
+  temp_synapse_interval.set_interval_size(network_inputs.size());
+  *partial_solution.add_input_data() = temp_synapse_interval;
+  CHECK( true == Partial_solution_solver(partial_solution).is_valid() );
+
+  /* Second Neuron takes its input from itself */
+  Partial_solution invalid_partial = partial_solution;
+  invalid_partial.mutable_inside_indices(1)->set_starts(1);
+  CHECK_THROWS( Partial_solution_solver(invalid_partial) );
+
+  /* First Neuron takes more inputs, than the partial solution has */
+  invalid_partial = partial_solution;
+  invalid_partial.mutable_inside_indices(0)->set_interval_size(network_inputs.size() + 1);
+  invalid_partial.mutable_weight_indices(0)->set_interval_size(network_inputs.size() + 1);
+  CHECK_THROWS( Partial_solution_solver(invalid_partial) );
+
+  /* First Neuron has more weights, than inputs */
+  invalid_partial = partial_solution;
+  invalid_partial.mutable_weight_indices(0)->set_interval_size(network_inputs.size() + 1);
+  CHECK_THROWS( Partial_solution_solver(invalid_partial) );
+
+  /* Bias points out of the weight table */
+  invalid_partial = partial_solution;
+  invalid_partial.set_bias_index(1, invalid_partial.weight_table_size());
+  CHECK_THROWS( Partial_solution_solver(invalid_partial) );
+
+  /* In checked mode a too small network input is detected while collecting the inputs */
+  Partial_solution_solver checked_solver(partial_solution, true);
+  vector<sdouble32> small_input = {10.0,5.0};
+  CHECK_THROWS( checked_solver.collect_input_data(small_input,{}) );
+  REQUIRE_NOTHROW( checked_solver.collect_input_data(network_inputs,{}) );
+  vector<sdouble32> neuron_output = checked_solver.solve();
+  vector<sdouble32> expected_neuron_output = vector<sdouble32>(2);
+  manual_2_neuron_result(network_inputs, expected_neuron_output, partial_solution);
+  CHECK( Approx(neuron_output[1]).epsilon(0.00000000000001) == expected_neuron_output[1] );
+}
+
+/*###############################################################################################
+ * Testing if a partial solution solved in ranges of independent Neurons gives the same result
+ * as solving it as a whole
+ * - Neurons 0-1: the second Neuron takes the first as input
+ * - Neurons 2-4: the last of them takes the two before it as input
+ * - Neuron 5: only takes the partial solution inputs
+ * - The ranges shall only start at Neurons 2 and 5
+ * - The ranges solved in reverse order shall give the same data, with Neuron memory, in batches as well
+ * - The wavefronts shall start at Neurons 1 and 4, and the ranges inside them shall be solvable in any order
+ *   once the wavefronts before them are solved
+ */
+void add_input_neuron(Partial_solution& partial_solution, sint32 input_starts, uint32 input_size){
+  Synapse_interval temp_synapse_interval;
+  partial_solution.add_actual_index(partial_solution.internal_neuron_number());
+  partial_solution.set_internal_neuron_number(partial_solution.internal_neuron_number() + 1);
+  partial_solution.add_neuron_transfer_functions(TRANSFER_FUNCTION_IDENTITY);
+  partial_solution.add_index_synapse_number(1u);
+  temp_synapse_interval.set_starts(input_starts);
+  temp_synapse_interval.set_interval_size(input_size);
+  *partial_solution.add_inside_indices() = temp_synapse_interval;
+  partial_solution.add_weight_synapse_number(1u);
+  temp_synapse_interval.set_starts(partial_solution.weight_table_size());
+  temp_synapse_interval.set_interval_size(input_size);
+  *partial_solution.add_weight_indices() = temp_synapse_interval;
+  for(uint32 weight_iterator = 0; weight_iterator < input_size; ++weight_iterator)
+    partial_solution.add_weight_table(static_cast<sdouble32>(rand()%11) / 10.0);
+  partial_solution.add_bias_index(partial_solution.weight_table_size());
+  partial_solution.add_weight_table(static_cast<sdouble32>(rand()%11) / 10.0);
+  partial_solution.add_memory_filter_index(partial_solution.weight_table_size());
+  partial_solution.add_weight_table(0.5); /* Every Neuron has memory */
+}
+
+TEST_CASE("Solving a Partial solution in ranges of independent Neurons","[solve][partial_solution][ranges]"){
+  vector<sdouble32> network_inputs = {1.9,2.8,3.7,4.6};
+  Partial_solution partial_solution;
+  Synapse_interval temp_synapse_interval;
+  temp_synapse_interval.set_starts(Synapse_iterator::synapse_index_from_input_index(0));
+  temp_synapse_interval.set_interval_size(network_inputs.size());
+  *partial_solution.add_input_data() = temp_synapse_interval;
+  add_input_neuron(partial_solution, Synapse_iterator::synapse_index_from_input_index(0), 4);
+  add_input_neuron(partial_solution, 0, 1);
+  add_input_neuron(partial_solution, Synapse_iterator::synapse_index_from_input_index(0), 2);
+  add_input_neuron(partial_solution, Synapse_iterator::synapse_index_from_input_index(2), 2);
+  add_input_neuron(partial_solution, 2, 2);
+  add_input_neuron(partial_solution, Synapse_iterator::synapse_index_from_input_index(0), 4);
+
+  Partial_solution_solver solver(partial_solution);
+  Partial_solution_solver range_solver(partial_solution, true);
+  REQUIRE( vector<uint32>({2,5}) == range_solver.get_independent_neurons() );
+
+  vector<sdouble32> collected_input(network_inputs.size());
+  solver.collect_input_data(network_inputs, {}, collected_input);
+  vector<sdouble32> expected_output(partial_solution.internal_neuron_number());
+  vector<sdouble32> output(partial_solution.internal_neuron_number());
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    solver.solve(collected_input, expected_output);
+    range_solver.solve(collected_input, output, 5, 6);
+    range_solver.solve(collected_input, output, 2, 5);
+    range_solver.solve(collected_input, output, 0, 2);
+    for(uint32 neuron_iterator = 0; neuron_iterator < output.size(); ++neuron_iterator)
+      CHECK( Approx(expected_output[neuron_iterator]).epsilon(0.00000000000001) == output[neuron_iterator] );
+  }
+  CHECK_THROWS( range_solver.solve(collected_input, output, 1, 2) ); /* The second Neuron depends on the first one */
+  CHECK_THROWS( range_solver.solve(collected_input, output, 2, 7) );
+
+  const uint32 batch_size = 3;
+  vector<sdouble32> batch_input(network_inputs.size() * batch_size);
+  for(uint32 input_iterator = 0; input_iterator < batch_input.size(); ++input_iterator)
+    batch_input[input_iterator] = network_inputs[input_iterator / batch_size] + (input_iterator % batch_size);
+  vector<sdouble32> expected_batch_output(partial_solution.internal_neuron_number() * batch_size);
+  vector<sdouble32> batch_output(partial_solution.internal_neuron_number() * batch_size);
+  range_solver.prepare_batch(batch_size);
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    solver.solve_batch(batch_input, expected_batch_output, batch_size);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 2, 5);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 5, 6);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 0, 2);
+    for(uint32 lane_iterator = 0; lane_iterator < batch_output.size(); ++lane_iterator)
+      CHECK( Approx(expected_batch_output[lane_iterator]).epsilon(0.00000000000001) == batch_output[lane_iterator] );
+  }
+
+  /* After the wavefronts before them, the ranges inside a wavefront can be solved in any order */
+  REQUIRE( vector<uint32>({1,4}) == range_solver.get_wavefronts() );
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    solver.solve(collected_input, expected_output);
+    range_solver.solve(collected_input, output, 0, 1, true);
+    range_solver.solve(collected_input, output, 3, 4, true);
+    range_solver.solve(collected_input, output, 1, 3, true);
+    range_solver.solve(collected_input, output, 5, 6, true);
+    range_solver.solve(collected_input, output, 4, 5, true);
+    for(uint32 neuron_iterator = 0; neuron_iterator < output.size(); ++neuron_iterator)
+      CHECK( Approx(expected_output[neuron_iterator]).epsilon(0.00000000000001) == output[neuron_iterator] );
+    solver.solve_batch(batch_input, expected_batch_output, batch_size);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 0, 1, true);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 2, 4, true);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 1, 2, true);
+    range_solver.solve_batch(batch_input, batch_output, batch_size, 4, 6, true); /* Starting at a wavefront */
+    for(uint32 lane_iterator = 0; lane_iterator < batch_output.size(); ++lane_iterator)
+      CHECK( Approx(expected_batch_output[lane_iterator]).epsilon(0.00000000000001) == batch_output[lane_iterator] );
+  }
+  CHECK_THROWS( range_solver.solve(collected_input, output, 3, 5, true) ); /* The fifth Neuron depends on the fourth one */
+  CHECK_THROWS( range_solver.solve(collected_input, output, 3, 4) );
+}
+
+/*###############################################################################################
+ * Testing if stateless Neurons are solved without their memory filter:
+ * - The first Neuron of the partial solution is stateless, with a memory filter which would ruin its data if read
+ * - The second Neuron has memory, so its data still follows its previous values
+ */
+TEST_CASE("Solving stateless Neurons without their memory filter","[solve][partial_solution][memory]"){
+  vector<sdouble32> network_inputs = {1.0,2.0};
+  Partial_solution partial_solution;
+  manual_2_neuron_partial_solution(partial_solution, network_inputs.size());
+  Synapse_interval temp_synapse_interval;
+  temp_synapse_interval.set_starts(Synapse_iterator::synapse_index_from_input_index(0));
+  temp_synapse_interval.set_interval_size(network_inputs.size());
+  *partial_solution.add_input_data() = temp_synapse_interval;
+  partial_solution.add_neuron_memoryless(true);
+  partial_solution.add_neuron_memoryless(false);
+  partial_solution.set_weight_table(partial_solution.memory_filter_index(0), std::numeric_limits<sdouble32>::quiet_NaN());
+  partial_solution.set_weight_table(partial_solution.memory_filter_index(1), 0.5);
+
+  Partial_solution_solver solver(partial_solution);
+  solver.collect_input_data(network_inputs, {});
+  const sdouble32 first_neuron = 1.0 + 2.0 + 50.0; /* Inputs with weights of 1.0, and the bias */
+  sdouble32 second_neuron = 0.0;
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    second_neuron = (second_neuron * 0.5) + ((first_neuron + 10.0) * 0.5);
+    vector<sdouble32> neuron_output = solver.solve();
+    CHECK( Approx(first_neuron).epsilon(0.00000000000001) == neuron_output[0] );
+    CHECK( Approx(second_neuron).epsilon(0.00000000000001) == neuron_output[1] );
+  }
+
+  const uint32 batch_size = 2;
+  vector<sdouble32> batch_input = {1.0,1.0,2.0,2.0};
+  vector<sdouble32> batch_output(partial_solution.internal_neuron_number() * batch_size);
+  solver.solve_batch(batch_input, batch_output, batch_size);
+  CHECK( Approx(first_neuron).epsilon(0.00000000000001) == batch_output[0] );
+  CHECK( Approx(first_neuron).epsilon(0.00000000000001) == batch_output[1] );
+  CHECK( Approx((first_neuron + 10.0) * 0.5).epsilon(0.00000000000001) == batch_output[2] );
+}
+
+/*###############################################################################################
+ * Testing if Neurons with the same inputs are solved together in blocks:
+ * - Neurons 0-12 take the same partial solution inputs, Neuron 5 with its weights in two synapses
+ * - Neurons 13-16 take the same Neurons 0-12 as input
+ * - The same Partial solution, with the inputs of every other Neuron in two synapses, has no Neurons with the same inputs
+ * - Both shall give the same data in every run, with Neuron memory, in ranges and in batches as well
+ */
+void split_last_synapse(Partial_solution& partial_solution, RepeatedPtrField<Synapse_interval>* synapses){
+  Synapse_interval& last_synapse = *synapses->Mutable(synapses->size() - 1);
+  const uint32 first_size = last_synapse.interval_size() / 2;
+  Synapse_interval second_synapse;
+  second_synapse.set_starts(
+    (Synapse_iterator::is_index_input(last_synapse.starts()))
+    ?(last_synapse.starts() - static_cast<sint32>(first_size)):(last_synapse.starts() + static_cast<sint32>(first_size))
+  );
+  second_synapse.set_interval_size(last_synapse.interval_size() - first_size);
+  last_synapse.set_interval_size(first_size);
+  *synapses->Add() = second_synapse;
+  if(synapses == partial_solution.mutable_inside_indices())
+    partial_solution.set_index_synapse_number(partial_solution.internal_neuron_number() - 1, 2u);
+    else partial_solution.set_weight_synapse_number(partial_solution.internal_neuron_number() - 1, 2u);
+}
+
+Partial_solution same_input_partial_solution(bool split_every_other_input){
+  Partial_solution partial_solution;
+  Synapse_interval temp_synapse_interval;
+  temp_synapse_interval.set_starts(Synapse_iterator::synapse_index_from_input_index(0));
+  temp_synapse_interval.set_interval_size(5);
+  *partial_solution.add_input_data() = temp_synapse_interval;
+  for(uint32 neuron_iterator = 0; neuron_iterator < 17; ++neuron_iterator){
+    if(neuron_iterator < 13) add_input_neuron(partial_solution, Synapse_iterator::synapse_index_from_input_index(0), 5);
+      else add_input_neuron(partial_solution, 0, 13);
+    if(5 == neuron_iterator) split_last_synapse(partial_solution, partial_solution.mutable_weight_indices());
+    if(split_every_other_input && (1 == (neuron_iterator % 2)))
+      split_last_synapse(partial_solution, partial_solution.mutable_inside_indices());
+  }
+  return partial_solution;
+}
+
+TEST_CASE("Solving Neurons with the same inputs together","[solve][partial_solution][same-inputs]"){
+  const vector<sdouble32> network_inputs = {0.9,-0.8,0.7,-0.6,0.5};
+  Partial_solution partial_solution = same_input_partial_solution(false);
+  Partial_solution separate_partial_solution = same_input_partial_solution(true);
+  *separate_partial_solution.mutable_weight_table() = partial_solution.weight_table();
+
+  Partial_solution_solver solver(partial_solution);
+  Partial_solution_solver checked_solver(partial_solution, true);
+  Partial_solution_solver separate_solver(separate_partial_solution);
+  CHECK( 13 == solver.get_same_input_neurons(0) );
+  CHECK( 8 == solver.get_same_input_neurons(5) );
+  CHECK( 1 == solver.get_same_input_neurons(12) );
+  CHECK( 4 == solver.get_same_input_neurons(13) );
+  for(uint32 neuron_iterator = 0; neuron_iterator < separate_partial_solution.internal_neuron_number(); ++neuron_iterator)
+    CHECK( 1 == separate_solver.get_same_input_neurons(neuron_iterator) );
+
+  vector<sdouble32> collected_input(network_inputs.size());
+  solver.collect_input_data(network_inputs, {}, collected_input);
+  std::unique_ptr<Partial_solution_solver> shared_solver;
+  { /* The shared input synapses are packed by the solver, so they only need to live while it is constructed */
+    RepeatedPtrField<Synapse_interval> shared_inside_indices = partial_solution.inside_indices();
+    shared_solver = std::make_unique<Partial_solution_solver>(
+      partial_solution, shared_inside_indices, partial_solution.index_synapse_number(), collected_input.size()
+    );
+  }
+  CHECK( shared_solver->is_valid() );
+  vector<sdouble32> expected_output(partial_solution.internal_neuron_number());
+  vector<sdouble32> output(partial_solution.internal_neuron_number());
+  vector<sdouble32> checked_output(partial_solution.internal_neuron_number());
+  vector<sdouble32> shared_output(partial_solution.internal_neuron_number());
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    separate_solver.solve(collected_input, expected_output);
+    solver.solve(collected_input, output);
+    checked_solver.solve(collected_input, checked_output, 0, 3, true);
+    checked_solver.solve(collected_input, checked_output, 3, 13, true);
+    checked_solver.solve(collected_input, checked_output, 13, 17, true);
+    shared_solver->solve(collected_input, shared_output);
+    CHECK( expected_output == output );
+    CHECK( expected_output == checked_output );
+    CHECK( expected_output == shared_output );
+  }
+
+  const uint32 batch_size = 3;
+  vector<sdouble32> batch_input(network_inputs.size() * batch_size);
+  for(uint32 input_iterator = 0; input_iterator < batch_input.size(); ++input_iterator)
+    batch_input[input_iterator] = network_inputs[input_iterator / batch_size] * (input_iterator % batch_size);
+  vector<sdouble32> expected_batch_output(partial_solution.internal_neuron_number() * batch_size);
+  vector<sdouble32> batch_output(partial_solution.internal_neuron_number() * batch_size);
+  vector<sdouble32> checked_batch_output(partial_solution.internal_neuron_number() * batch_size);
+  checked_solver.prepare_batch(batch_size);
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    separate_solver.solve_batch(batch_input, expected_batch_output, batch_size);
+    solver.solve_batch(batch_input, batch_output, batch_size);
+    checked_solver.solve_batch(batch_input, checked_batch_output, batch_size, 4, 13, true);
+    checked_solver.solve_batch(batch_input, checked_batch_output, batch_size, 0, 4, true);
+    checked_solver.solve_batch(batch_input, checked_batch_output, batch_size, 13, 17, true);
+    CHECK( expected_batch_output == batch_output );
+    CHECK( expected_batch_output == checked_batch_output );
+  }
 }
 
 } /* namespace sparse_net_library_test */
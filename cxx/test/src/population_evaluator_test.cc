@@ -0,0 +1,215 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+#include "gen/sparse_net.pb.h"
+#include "models/service_context.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/worker_pool.h"
+#include "services/population_evaluator.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::Worker_pool;
+using sparse_net_library::Population_evaluator;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if Solution solvers sharing a worker pool give the same results as the ones with their own workers,
+ * and a batch submitted without copying it gives the same results as a copied one
+ * */
+TEST_CASE( "Solution solvers sharing a worker pool", "[solve][population]" ){
+  vector<uint32> net_structure = {10,8,4};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(6).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> solution(Solution_builder().build(*net));
+  const sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(Solution_builder().max_solve_threads(4).device_max_megabytes(solution_size / 3.0).build(*net));
+
+  const uint32 batch_size = 4;
+  Worker_pool workers(3);
+  Solution_solver reference_solver(*solution);
+  Solution_solver first_solver(*solution, Service_context().set_worker_pool(&workers));
+  Solution_solver second_solver(*solution, Service_context().set_worker_pool(&workers));
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    std::shared_ptr<vector<sdouble32>> batch = std::make_shared<vector<sdouble32>>(net->input_data_size() * batch_size);
+    for(sdouble32& input : *batch) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_result = reference_solver.solve_batch(*batch, batch_size);
+    std::future<vector<sdouble32>> first_result = first_solver.submit_batch(std::shared_ptr<const vector<sdouble32>>(batch), batch_size);
+    std::future<vector<sdouble32>> second_result = second_solver.submit_batch(*batch, batch_size);
+    batch.reset(); /* The jobs keep the shared batch alive */
+    vector<sdouble32> first_output = first_result.get();
+    vector<sdouble32> second_output = second_result.get();
+    REQUIRE( expected_result.size() == first_output.size() );
+    REQUIRE( expected_result.size() == second_output.size() );
+    for(uint32 output_iterator = 0; output_iterator < expected_result.size(); ++output_iterator){
+      CHECK( Approx(expected_result[output_iterator]).epsilon(0.00000000000001) == first_output[output_iterator] );
+      CHECK( Approx(expected_result[output_iterator]).epsilon(0.00000000000001) == second_output[output_iterator] );
+    }
+  }
+  CHECK_THROWS( first_solver.submit_batch(std::shared_ptr<const vector<sdouble32>>(), batch_size) );
+}
+
+/*###############################################################################################
+ * Testing if a population of different nets is evaluated correctly:
+ * - The error of every candidate shall match the error calculated from the outputs of its own solver,
+ *   solving the same batches, including a smaller last batch
+ * - Throughput shall be reported
+ * - Evaluating again continues the Neuron memory of the candidates
+ * */
+TEST_CASE( "Evaluating a population of nets", "[solve][population]" ){
+  vector<vector<uint32>> net_structures = {{10,4}, {6,8,4}, {12,5,7,4}};
+  vector<unique_ptr<SparseNet>> nets;
+  vector<const SparseNet*> population;
+  for(const vector<uint32>& net_structure : net_structures){
+    unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+    net_builder->input_size(5).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+    nets.push_back(unique_ptr<SparseNet>(net_builder->dense_layers(net_structure)));
+    population.push_back(nets.back().get());
+  }
+  Solution_builder solution_builder;
+  solution_builder.max_solve_threads(4).device_max_megabytes(0.002);
+  Population_evaluator evaluator(population, solution_builder, Service_context().set_max_solve_threads(3));
+  REQUIRE( population.size() == evaluator.get_number_of_candidates() );
+
+  const uint32 number_of_samples = 23;
+  const uint32 batch_size = 5;
+  vector<vector<sdouble32>> input_samples(number_of_samples, vector<sdouble32>(5));
+  vector<vector<sdouble32>> label_samples(number_of_samples, vector<sdouble32>(4));
+  for(vector<sdouble32>& input : input_samples)
+    for(sdouble32& value : input) value = static_cast<sdouble32>(rand()%100) / 10.0;
+  for(vector<sdouble32>& label : label_samples)
+    for(sdouble32& value : label) value = static_cast<sdouble32>(rand()%100) / 10.0;
+
+  vector<unique_ptr<Solution>> reference_solutions;
+  vector<unique_ptr<Solution_solver>> reference_solvers;
+  for(const SparseNet* net : population){
+    reference_solutions.push_back(unique_ptr<Solution>(solution_builder.build(*net)));
+    CHECK( reference_solutions.back()->SerializeAsString() == evaluator.get_solution(reference_solvers.size()).SerializeAsString() );
+    reference_solvers.push_back(make_unique<Solution_solver>(*reference_solutions.back()));
+  }
+
+  for(uint32 evaluation_iterator = 0; evaluation_iterator < 2; ++evaluation_iterator){
+    vector<sdouble32> expected_errors(population.size(), 0.0);
+    for(uint32 first_sample = 0; first_sample < number_of_samples; first_sample += batch_size){
+      const uint32 lanes = std::min(batch_size, number_of_samples - first_sample);
+      vector<sdouble32> batch(5 * lanes);
+      for(uint32 lane_iterator = 0; lane_iterator < lanes; ++lane_iterator)
+        for(uint32 input_iterator = 0; input_iterator < 5; ++input_iterator)
+          batch[input_iterator * lanes + lane_iterator] = input_samples[first_sample + lane_iterator][input_iterator];
+      for(uint32 candidate_index = 0; candidate_index < population.size(); ++candidate_index){
+        vector<sdouble32> outputs = reference_solvers[candidate_index]->solve_batch(batch, lanes);
+        for(uint32 lane_iterator = 0; lane_iterator < lanes; ++lane_iterator)
+          for(uint32 output_iterator = 0; output_iterator < 4; ++output_iterator)
+            expected_errors[candidate_index] += 0.5 * std::pow(
+              outputs[output_iterator * lanes + lane_iterator] - label_samples[first_sample + lane_iterator][output_iterator], 2.0
+            ) / number_of_samples;
+      }
+    }
+
+    Population_evaluator::Evaluation evaluation = evaluator.evaluate(input_samples, label_samples, batch_size);
+    REQUIRE( population.size() == evaluation.errors.size() );
+    for(uint32 candidate_index = 0; candidate_index < population.size(); ++candidate_index)
+      CHECK( Approx(expected_errors[candidate_index]).epsilon(0.00000000001) == evaluation.errors[candidate_index] );
+    CHECK( 0.0 < evaluation.seconds );
+    CHECK( Approx(population.size() * number_of_samples / evaluation.seconds) == evaluation.candidate_samples_per_second );
+  }
+
+  CHECK_THROWS( evaluator.evaluate(input_samples, label_samples, 0) );
+  CHECK_THROWS( evaluator.evaluate(input_samples, vector<vector<sdouble32>>(number_of_samples, vector<sdouble32>(3)), batch_size) );
+  label_samples.pop_back();
+  CHECK_THROWS( evaluator.evaluate(input_samples, label_samples, batch_size) );
+  CHECK_THROWS( Population_evaluator({population[0], nullptr}) );
+}
+
+/*###############################################################################################
+ * Testing if candidates are raced against a cost bound correctly:
+ * - The lowest expected error shall consider the evaluated samples, and the confidence bound of the rest
+ * - A candidate able to beat the bound shall be evaluated with every sample
+ * - A candidate worse than the bound shall be stopped early, with its error on the samples it is evaluated with
+ * */
+TEST_CASE( "Racing a population of nets against a cost bound", "[solve][population][race]" ){
+  const sdouble32 infinity = std::numeric_limits<sdouble32>::infinity();
+  CHECK( Approx(0.1) == Population_evaluator::get_lowest_expected_error(10.0, 10.0, 10, 100, infinity) );
+  CHECK( Approx(1.0) == Population_evaluator::get_lowest_expected_error(10.0, 10.0, 10, 100, 2.0) ); /* No variance */
+  CHECK( Approx(0.1) == Population_evaluator::get_lowest_expected_error(10.0, 100.0, 10, 100, 2.0) ); /* One costly sample */
+  CHECK( Approx(1.0) == Population_evaluator::get_lowest_expected_error(100.0, 200.0, 100, 100, 2.0) ); /* Every sample evaluated */
+
+  vector<vector<uint32>> net_structures = {{6,3}, {8,5,3}};
+  vector<unique_ptr<SparseNet>> nets;
+  vector<const SparseNet*> population;
+  for(const vector<uint32>& net_structure : net_structures){
+    unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+    net_builder->input_size(4).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+    nets.push_back(unique_ptr<SparseNet>(net_builder->dense_layers(net_structure)));
+    population.push_back(nets.back().get());
+  }
+
+  /* The labels are the outputs of the first candidate, so it can beat any positive bound */
+  const uint32 number_of_samples = 60;
+  const uint32 batch_size = 5;
+  vector<vector<sdouble32>> input_samples(number_of_samples, vector<sdouble32>(4));
+  vector<vector<sdouble32>> label_samples(number_of_samples);
+  for(vector<sdouble32>& input : input_samples)
+    for(sdouble32& value : input) value = static_cast<sdouble32>(rand()%100) / 10.0;
+  unique_ptr<Solution> first_solution(Solution_builder().build(*population[0]));
+  Solution_solver first_solver(*first_solution);
+  for(uint32 first_sample = 0; first_sample < number_of_samples; first_sample += batch_size){
+    vector<sdouble32> batch(4 * batch_size);
+    for(uint32 lane_iterator = 0; lane_iterator < batch_size; ++lane_iterator)
+      for(uint32 input_iterator = 0; input_iterator < 4; ++input_iterator)
+        batch[input_iterator * batch_size + lane_iterator] = input_samples[first_sample + lane_iterator][input_iterator];
+    vector<sdouble32> outputs = first_solver.solve_batch(batch, batch_size);
+    for(uint32 lane_iterator = 0; lane_iterator < batch_size; ++lane_iterator)
+      for(uint32 output_iterator = 0; output_iterator < 3; ++output_iterator)
+        label_samples[first_sample + lane_iterator].push_back(outputs[output_iterator * batch_size + lane_iterator]);
+  }
+
+  Population_evaluator evaluator(population, Solution_builder(), Service_context().set_max_solve_threads(2));
+  Population_evaluator reference_evaluator(population, Solution_builder(), Service_context().set_max_solve_threads(2));
+  Population_evaluator::Evaluation reference = reference_evaluator.evaluate(input_samples, label_samples, batch_size);
+  REQUIRE( 0.0 < reference.errors[1] );
+  Population_evaluator::Evaluation evaluation = evaluator.race(input_samples, label_samples, batch_size, 0.000001);
+  REQUIRE( 2 == evaluation.errors.size() );
+  CHECK( number_of_samples == reference.evaluated_samples[1] );
+  CHECK( number_of_samples == evaluation.evaluated_samples[0] );
+  CHECK( Approx(0.0).margin(0.0000000001) == evaluation.errors[0] );
+  CHECK( batch_size == evaluation.evaluated_samples[1] ); /* Stopped after the first batch */
+  CHECK( 0.0 < evaluation.errors[1] );
+
+  /* Surely worse than half of its error, once the samples so far cost more than the bound */
+  evaluation = evaluator.race(input_samples, label_samples, batch_size, reference.errors[1] / 2.0, 1.0);
+  CHECK( number_of_samples == evaluation.evaluated_samples[0] );
+  CHECK( number_of_samples > evaluation.evaluated_samples[1] );
+  CHECK( batch_size <= evaluation.evaluated_samples[1] );
+  CHECK( (number_of_samples * reference.errors[1] / 2.0) < (evaluation.errors[1] * evaluation.evaluated_samples[1]) );
+  evaluation = evaluator.race(input_samples, label_samples, batch_size, infinity);
+  CHECK( number_of_samples == evaluation.evaluated_samples[1] );
+
+  CHECK_THROWS( evaluator.race(input_samples, label_samples, batch_size, 1.0, 0.4) );
+  CHECK_THROWS( evaluator.race(input_samples, label_samples, batch_size, 1.0, 1.1) );
+  CHECK_THROWS( evaluator.race(input_samples, label_samples, batch_size, std::numeric_limits<sdouble32>::quiet_NaN()) );
+}
+
+} /* namespace sparse_net_library_test */
@@ -6,6 +6,8 @@
 #include "services/sparse_net_builder.h"
 #include "services/solution_builder.h"
 #include "services/solution_solver.h"
+#include "services/weight_updater.h"
+#include "services/partial_solution_builder.h"
 
 namespace sparse_net_library_test {
 
@@ -14,6 +16,7 @@ using std::make_unique;
 using std::vector;
 
 using sparse_net_library::uint32;
+using sparse_net_library::uint64;
 using sparse_net_library::sdouble32;
 using sparse_net_library::Sparse_net_builder;
 using sparse_net_library::SparseNet;
@@ -21,7 +24,14 @@ using sparse_net_library::Solution_builder;
 using sparse_net_library::Solution;
 using sparse_net_library::Solution_solver;
 using sparse_net_library::Synapse_iterator;
+using sparse_net_library::Synapse_interval;
+using sparse_net_library::Neuron;
+using sparse_net_library::Weight_updater;
+using sparse_net_library::Partial_solution_builder;
+using sparse_net_library::TRANSFER_FUNCTION_SIGMOID;
+using sparse_net_library::TRANSFER_FUNCTION_IDENTITY;
 using sparse_net_library::COST_FUNCTION_QUADRATIC;
+using sparse_net_library::WEIGHT_STORAGE_FP16;
 
 /*###############################################################################################
  * Testing Solution generation using the @Sparse_net_builder and the @Solution_builder
@@ -145,4 +155,238 @@ TEST_CASE( "Building a solution from a net", "[build][small][build-only]" ){
   delete solution;
 }
 
+/*###############################################################################################
+ * Testing if the weights shared between Neurons are stored only once inside the @Solution:
+ * - A convolution-like layer slides the same 3 weights and bias over the inputs
+ * - The weight table of the @Solution shall scale with the unique weights, not with the connections
+ * - The @Solution shall give the same results as the one built from a net with every weight copied for every Neuron
+ * - Updating a shared weight shall update it for every Neuron using it
+ * */
+SparseNet* build_convolution_like_net(bool tie_weights){
+  const uint32 input_size = 8;
+  const uint32 window_size = 3;
+  const uint32 convolution_neurons = input_size - window_size + 1;
+  const vector<sdouble32> kernel = {0.5, -0.25, 0.75};
+  const sdouble32 kernel_bias = 0.125;
+  vector<sdouble32> weight_table;
+  vector<Neuron> neuron_array(convolution_neurons + 2);
+  Synapse_interval temp_synapse_interval;
+
+  for(uint32 neuron_iterator = 0; neuron_iterator < convolution_neurons; ++neuron_iterator){
+    Neuron& neuron = neuron_array[neuron_iterator];
+    if(tie_weights && (0 < neuron_iterator)){ /* Every Neuron uses the weights of the first one */
+      neuron.set_bias_idx(neuron_array[0].bias_idx());
+      *neuron.add_input_weights() = neuron_array[0].input_weights(0);
+    }else{
+      temp_synapse_interval.set_starts(weight_table.size());
+      temp_synapse_interval.set_interval_size(window_size);
+      *neuron.add_input_weights() = temp_synapse_interval;
+      weight_table.insert(weight_table.end(), kernel.begin(), kernel.end());
+      neuron.set_bias_idx(weight_table.size());
+      weight_table.push_back(kernel_bias);
+    }
+    neuron.set_memory_filter_idx(weight_table.size()); /* Every Neuron has a memory filter of its own */
+    weight_table.push_back(0.0);
+    neuron.set_transfer_function_idx(TRANSFER_FUNCTION_SIGMOID);
+    temp_synapse_interval.set_starts(Synapse_iterator::synapse_index_from_input_index(neuron_iterator));
+    temp_synapse_interval.set_interval_size(window_size);
+    *neuron.add_input_indices() = temp_synapse_interval;
+  }
+
+  for(uint32 neuron_iterator = convolution_neurons; neuron_iterator < neuron_array.size(); ++neuron_iterator){
+    Neuron& neuron = neuron_array[neuron_iterator];
+    temp_synapse_interval.set_starts(weight_table.size());
+    temp_synapse_interval.set_interval_size(convolution_neurons);
+    *neuron.add_input_weights() = temp_synapse_interval;
+    for(uint32 weight_iterator = 0; weight_iterator < convolution_neurons; ++weight_iterator)
+      weight_table.push_back(0.1 * (weight_iterator + neuron_iterator) - 0.4);
+    neuron.set_bias_idx(weight_table.size());
+    weight_table.push_back(-0.5);
+    neuron.set_memory_filter_idx(weight_table.size());
+    weight_table.push_back(0.0);
+    neuron.set_transfer_function_idx(TRANSFER_FUNCTION_IDENTITY);
+    temp_synapse_interval.set_starts(0);
+    temp_synapse_interval.set_interval_size(convolution_neurons);
+    *neuron.add_input_indices() = temp_synapse_interval;
+  }
+
+  return Sparse_net_builder()
+    .input_size(input_size).expected_input_range(1.0).output_neuron_number(2)
+    .cost_function(COST_FUNCTION_QUADRATIC).neuron_array(neuron_array).weight_table(weight_table)
+    .build();
+}
+
+TEST_CASE( "Building a solution from a net with weights shared between Neurons", "[build][shared-weights]" ){
+  unique_ptr<SparseNet> tied_net(build_convolution_like_net(true));
+  unique_ptr<SparseNet> untied_net(build_convolution_like_net(false));
+  unique_ptr<Solution> tied_solution(Solution_builder().build(*tied_net));
+  unique_ptr<Solution> untied_solution(Solution_builder().build(*untied_net));
+
+  uint32 tied_weights = 0;
+  uint32 untied_weights = 0;
+  uint32 connections = 0;
+  for(const sparse_net_library::Partial_solution& partial : tied_solution->partial_solutions())
+    tied_weights += partial.weight_table_size();
+  for(const sparse_net_library::Partial_solution& partial : untied_solution->partial_solutions())
+    untied_weights += partial.weight_table_size();
+  for(const Neuron& neuron : tied_net->neuron_array())
+    connections += Synapse_iterator(neuron.input_indices()).size() + 1; /* inputs and bias */
+  CHECK( static_cast<uint32>(untied_net->weight_table_size()) == untied_weights );
+  CHECK( static_cast<uint32>(tied_net->weight_table_size()) == tied_weights );
+  CHECK( tied_weights < untied_weights );
+  CHECK( tied_weights < connections );
+
+  Solution_solver tied_solver(*tied_solution);
+  Solution_solver untied_solver(*untied_solution);
+  const vector<sdouble32> input = {0.1, -0.2, 0.3, 0.9, -0.7, 0.25, 0.0, 1.0};
+  const vector<sdouble32> original_result = tied_solver.solve(input);
+  CHECK( original_result == untied_solver.solve(input) );
+
+  /* Update the middle weight of the kernel, which is shared by every convolution-like Neuron */
+  const sdouble32 updated_weight = -1.5;
+  const uint32 shared_weight_index = tied_net->neuron_array(0).input_weights(0).starts() + 1;
+  vector<uint32> untied_weight_indices;
+  for(uint32 neuron_iterator = 0; neuron_iterator < 6; ++neuron_iterator)
+    untied_weight_indices.push_back(untied_net->neuron_array(neuron_iterator).input_weights(0).starts() + 1);
+  Weight_updater(*tied_solution).update({shared_weight_index}, {updated_weight});
+  Weight_updater(*untied_solution).update(untied_weight_indices, vector<sdouble32>(untied_weight_indices.size(), updated_weight));
+  tied_solver.refresh_neurons();
+  untied_solver.refresh_neurons();
+  const vector<sdouble32> tied_result = tied_solver.solve(input);
+  CHECK( tied_result == untied_solver.solve(input) );
+  CHECK( tied_result != original_result );
+}
+
+/*###############################################################################################
+ * Testing if Neurons sharing their inputs inside a @Partial_solution read them from the same place:
+ * - Every network input is taken into the @Partial_solution only once, Neurons inside it are not taken at all
+ * - Every Neuron shall still read the same inputs as in the net
+ * - A builder continuing a @Partial_solution shall find the inputs, Neurons and weights already inside it,
+ *   so the result is the same as building it in one go
+ * */
+/* Collects the network index of every input of every Neuron inside the given @Partial_solution */
+vector<vector<int>> partial_neuron_inputs(const sparse_net_library::Partial_solution& partial){
+  vector<vector<int>> neuron_inputs(partial.internal_neuron_number());
+  vector<int> partial_inputs;
+  Synapse_iterator(partial.input_data()).iterate([&](int input_index){
+    partial_inputs.push_back(input_index);
+  });
+  uint32 index_synapse_start = 0;
+  for(uint32 neuron_iterator = 0; neuron_iterator < partial.internal_neuron_number(); ++neuron_iterator){
+    Synapse_iterator(partial.inside_indices()).iterate([&](int inside_index){
+      if(Synapse_iterator::is_index_input(inside_index))
+        neuron_inputs[neuron_iterator].push_back(partial_inputs[Synapse_iterator::input_index_from_synapse_index(inside_index)]);
+      else neuron_inputs[neuron_iterator].push_back(partial.actual_index(inside_index));
+    }, index_synapse_start, partial.index_synapse_number(neuron_iterator));
+    index_synapse_start += partial.index_synapse_number(neuron_iterator);
+  }
+  return neuron_inputs;
+}
+
+TEST_CASE( "Building a partial solution from Neurons sharing their inputs", "[build][partial-inputs]" ){
+  const uint32 input_size = 64;
+  const uint32 neuron_number = 48;
+  vector<Neuron> neuron_array(neuron_number);
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_number; ++neuron_iterator){
+    Neuron& neuron = neuron_array[neuron_iterator];
+    vector<int> inputs; /* Network inputs scattered between the Neurons, and some Neurons before this one */
+    for(uint32 input_iterator = 0; input_iterator < 6; ++input_iterator)
+      inputs.push_back(Synapse_iterator::synapse_index_from_input_index((neuron_iterator * 7 + input_iterator * 13) % input_size));
+    if(0 < neuron_iterator){
+      inputs.push_back(neuron_iterator - 1);
+      inputs.push_back((neuron_iterator * 5) % neuron_iterator);
+    }
+    for(int input_index : inputs){
+      Synapse_interval* input_synapse = neuron.add_input_indices();
+      input_synapse->set_starts(input_index);
+      input_synapse->set_interval_size(1);
+    }
+    Synapse_interval* weight_synapse = neuron.add_input_weights();
+    weight_synapse->set_starts(0);
+    weight_synapse->set_interval_size(inputs.size());
+    neuron.set_bias_idx(0);
+    neuron.set_memory_filter_idx(0);
+    neuron.set_transfer_function_idx(TRANSFER_FUNCTION_IDENTITY);
+  }
+  unique_ptr<SparseNet> net(Sparse_net_builder()
+    .input_size(input_size).expected_input_range(1.0).output_neuron_number(1)
+    .cost_function(COST_FUNCTION_QUADRATIC).neuron_array(neuron_array).weight_table(vector<sdouble32>(8, 0.5))
+    .build());
+
+  sparse_net_library::Partial_solution partial;
+  Partial_solution_builder builder(*net, partial);
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_number; ++neuron_iterator)
+    builder.add_neuron_to_partial_solution(neuron_iterator);
+
+  /* Every network input is taken into the @Partial_solution only once, and Neurons inside it are not taken at all */
+  CHECK( input_size == Synapse_iterator(partial.input_data()).size() );
+  const vector<vector<int>> neuron_inputs = partial_neuron_inputs(partial);
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_number; ++neuron_iterator){
+    vector<int> expected_inputs;
+    Synapse_iterator(net->neuron_array(neuron_iterator).input_indices()).iterate([&](int input_index){
+      expected_inputs.push_back(input_index);
+    });
+    CHECK( expected_inputs == neuron_inputs[neuron_iterator] );
+  }
+
+  /* A builder continuing a @Partial_solution finds the inputs, Neurons and weights already inside it */
+  sparse_net_library::Partial_solution continued_partial;
+  Partial_solution_builder first_builder(*net, continued_partial);
+  for(uint32 neuron_iterator = 0; neuron_iterator < (neuron_number / 2); ++neuron_iterator)
+    first_builder.add_neuron_to_partial_solution(neuron_iterator);
+  Partial_solution_builder continuing_builder(*net, continued_partial);
+  for(uint32 neuron_iterator = (neuron_number / 2); neuron_iterator < neuron_number; ++neuron_iterator)
+    continuing_builder.add_neuron_to_partial_solution(neuron_iterator);
+  CHECK( continued_partial.inside_indices_size() == partial.inside_indices_size() );
+  CHECK( continued_partial.input_data_size() == partial.input_data_size() );
+  CHECK( neuron_inputs == partial_neuron_inputs(continued_partial) );
+  CHECK( continued_partial.weight_table_size() == partial.weight_table_size() );
+  CHECK( continued_partial.SerializeAsString() == partial.SerializeAsString() );
+}
+
+/*###############################################################################################
+ * Testing if the size of the @Partial_solution elements calculated while building them
+ * follows the space they actually use, and the partials are divided based on it:
+ * - The calculated size shall be within the stated tolerance of @SpaceUsedLong in both directions,
+ *   after every added Neuron and in the built @Solution as well, with the weights stored in 16 bits too
+ */
+void check_partial_size(const sparse_net_library::Partial_solution& partial){
+  const uint64 calculated_size = Partial_solution_builder::get_partial_size_bytes(partial);
+  const uint64 space_used = partial.SpaceUsedLong();
+  INFO( "Calculated size: " << calculated_size << " bytes; space used: " << space_used << " bytes" );
+  CHECK( space_used <= (calculated_size + Partial_solution_builder::size_tolerance_bytes) );
+  CHECK( calculated_size <= (space_used + Partial_solution_builder::size_tolerance_bytes) );
+}
+
+TEST_CASE( "Calculating the size of partial solutions while building them", "[build][partial-size]" ){
+  unique_ptr<SparseNet> net(Sparse_net_builder()
+    .input_size(50).output_neuron_number(2).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC)
+    .dense_layers({20,10,30,10,2}));
+  sparse_net_library::Partial_solution built_partial;
+  Partial_solution_builder builder(*net, built_partial);
+  for(uint32 neuron_iterator = 0; neuron_iterator < 20; ++neuron_iterator){
+    builder.add_neuron_to_partial_solution(neuron_iterator);
+    check_partial_size(built_partial);
+  }
+
+  unique_ptr<Solution> whole_solution(Solution_builder().max_solve_threads(4).build(*net));
+  uint64 whole_size = 0;
+  for(const sparse_net_library::Partial_solution& partial : whole_solution->partial_solutions()){
+    check_partial_size(partial);
+    whole_size += Partial_solution_builder::get_partial_size_bytes(partial);
+  }
+
+  /* A limit well below the size of a whole row divides it into multiple partials */
+  const sdouble32 max_megabytes = (whole_size / 5.0) /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  unique_ptr<Solution> divided_solution(Solution_builder().max_solve_threads(4).device_max_megabytes(max_megabytes).build(*net));
+  CHECK( whole_solution->partial_solutions_size() < divided_solution->partial_solutions_size() );
+  CHECK( whole_solution->neuron_number() == divided_solution->neuron_number() );
+  for(const sparse_net_library::Partial_solution& partial : divided_solution->partial_solutions())
+    check_partial_size(partial);
+
+  unique_ptr<Solution> half_solution(Solution_builder().max_solve_threads(4).weight_storage(WEIGHT_STORAGE_FP16).build(*net));
+  for(const sparse_net_library::Partial_solution& partial : half_solution->partial_solutions())
+    check_partial_size(partial);
+}
+
 } /* namespace sparse_net_library_test */
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <limits>
 
 #include "test/test_mockups.h"
 
@@ -9,6 +10,7 @@
 #include "gen/sparse_net.pb.h"
 #include "models/transfer_function.h"
 #include "models/service_context.h"
+#include "models/input_transformer.h"
 #include "services/solution_solver.h"
 #include "services/partial_solution_solver.h"
 #include "services/synapse_iterator.h"
@@ -254,4 +256,524 @@ TEST_CASE("Solution Solver test based on Fully Connected Dense Net", "[solve][bu
   testing_solution_solver_manually(nullptr);
 }
 
+/*###############################################################################################
+ * Testing if the solution solver produces the correct outputs when many inputs are submitted
+ * without waiting for the results of the previous ones
+ * - The Neurons of the built net have memory, so the results depend on the order of the inputs
+ * - The results are compared to the manual calculation of the inputs one after another
+ */
+void testing_solution_solver_submissions(google::protobuf::Arena* arena, uint16 threads){
+  using std::unique_ptr;
+  using std::make_unique;
+  using std::future;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {2,4,3,10,20};
+  vector<vector<sdouble32>> net_inputs = vector<vector<sdouble32>>();
+  for(uint32 sample_iterator = 0; sample_iterator < 50; ++sample_iterator){
+    net_inputs.push_back(vector<sdouble32>(5));
+    for(sdouble32& input : net_inputs.back()) input = static_cast<sdouble32>(rand()%100) / 10.0;
+  }
+
+  /* Build the described net */
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(5).expected_input_range(5.0)
+  .cost_function(COST_FUNCTION_QUADRATIC).arena_ptr(arena);
+  SparseNet* net(net_builder->dense_layers(net_structure));
+  net_builder.reset();
+
+  /* Generate solution from Net, divided into multiple partial solutions */
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  Solution* solution = solution_builder->max_solve_threads(4).device_max_megabytes(2048).arena_ptr(arena).build(*net);
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  if(nullptr == arena) delete solution;
+  solution = solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/4.0).arena_ptr(arena).build(*net);
+
+  /* Submit every input at once */
+  vector<future<vector<sdouble32>>> results;
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(threads));
+  for(vector<sdouble32>& input : net_inputs) results.push_back(solver.submit(input));
+
+  /* Verify the results in order of submission */
+  vector<sdouble32> expected_neuron_data = vector<sdouble32>(net->neuron_array_size());
+  vector<sdouble32> result;
+  for(uint32 sample_iterator = 0; sample_iterator < net_inputs.size(); ++sample_iterator){
+    manaual_fully_connected_network_result(net_inputs[sample_iterator], expected_neuron_data, net_structure,*net);
+    result = results[sample_iterator].get();
+    REQUIRE( net_structure.back() == result.size() );
+    for(uint32 result_iterator = 0; result_iterator < result.size(); ++result_iterator){
+      CHECK(
+        Approx(result[result_iterator]).epsilon(0.00000000000001)
+        == expected_neuron_data[expected_neuron_data.size() - result.size() + result_iterator]
+      );
+    }
+  }
+  if(nullptr == arena){
+    delete solution;
+    delete net;
+  }
+}
+
+TEST_CASE("Solution Solver asynchronous submissions", "[solve][async]"){
+  testing_solution_solver_submissions(nullptr, 1);
+  testing_solution_solver_submissions(nullptr, 4);
+}
+
+/*###############################################################################################
+ * Testing if the solution solver verifies the structure of the @Solution once at construction
+ * - A built solution shall be accepted, and solved the same way in checked and unchecked mode
+ * - Solutions with Neurons calculated multiple times, outputs out of bounds
+ *   or inputs from the same row shall be rejected
+ */
+TEST_CASE("Solution Solver structure verification", "[solve][verification]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {2,4,3,10,20};
+  vector<sdouble32> net_input = {10.0,20.0,30.0,40.0,50.0};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(5).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/4.0).build(*net));
+  REQUIRE( 1 < solution->cols_size() );
+
+  Solution_solver solver(*solution);
+  Solution_solver checked_solver(*solution, Service_context().set_checked_solve(true));
+  REQUIRE( true == solver.is_valid() );
+  vector<sdouble32> result = solver.solve(net_input);
+  vector<sdouble32> checked_result = checked_solver.solve(net_input);
+  REQUIRE( result.size() == checked_result.size() );
+  for(uint32 result_iterator = 0; result_iterator < result.size(); ++result_iterator)
+    CHECK( Approx(result[result_iterator]).epsilon(0.00000000000001) == checked_result[result_iterator] );
+  CHECK_THROWS( solver.solve({10.0,20.0}) ); /* Input too small */
+
+  /* A Neuron is calculated by multiple @Partial_solution elements */
+  Solution invalid_solution = *solution;
+  invalid_solution.mutable_partial_solutions(1)->mutable_output_data(0)->set_starts(0);
+  CHECK_THROWS( Solution_solver(invalid_solution) );
+
+  /* Outputs out of bounds */
+  invalid_solution = *solution;
+  invalid_solution.set_neuron_number(solution->neuron_number() - 1);
+  CHECK_THROWS( Solution_solver(invalid_solution) );
+
+  /* The second row takes the output of itself as input */
+  invalid_solution = *solution;
+  invalid_solution.mutable_partial_solutions(1)->mutable_input_data(0)->set_starts(
+    invalid_solution.partial_solutions(1).output_data(0).starts()
+  );
+  CHECK_THROWS( Solution_solver(invalid_solution) );
+}
+
+TEST_CASE("Solution Solver batches of independent samples", "[solve][batch]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {6,8,5,3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(5).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/3.0).build(*net));
+
+  /* Every sample of the batch is compared to a solver solving only that sample */
+  const uint32 batch_size = 7;
+  Solution_solver batch_solver(*solution);
+  Solution_solver checked_batch_solver(*solution, Service_context().set_checked_solve(true));
+  vector<unique_ptr<Solution_solver>> sample_solvers;
+  for(uint32 sample_iterator = 0; sample_iterator < batch_size; ++sample_iterator)
+    sample_solvers.push_back(make_unique<Solution_solver>(*solution));
+
+  vector<sdouble32> batch_input(net->input_data_size() * batch_size);
+  vector<sdouble32> sample_input(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& input : batch_input) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> batch_result = batch_solver.solve_batch(batch_input, batch_size);
+    vector<sdouble32> checked_batch_result = checked_batch_solver.solve_batch(batch_input, batch_size);
+    REQUIRE( (solution->output_neuron_number() * batch_size) == batch_result.size() );
+    REQUIRE( batch_result.size() == checked_batch_result.size() );
+    for(uint32 sample_iterator = 0; sample_iterator < batch_size; ++sample_iterator){
+      for(uint32 input_iterator = 0; input_iterator < sample_input.size(); ++input_iterator)
+        sample_input[input_iterator] = batch_input[input_iterator * batch_size + sample_iterator];
+      vector<sdouble32> sample_result = sample_solvers[sample_iterator]->solve(sample_input);
+      for(uint32 output_iterator = 0; output_iterator < sample_result.size(); ++output_iterator){
+        CHECK( Approx(sample_result[output_iterator]).epsilon(0.00000000000001) == batch_result[output_iterator * batch_size + sample_iterator] );
+        CHECK( Approx(sample_result[output_iterator]).epsilon(0.00000000000001) == checked_batch_result[output_iterator * batch_size + sample_iterator] );
+      }
+    }
+  }
+  CHECK_THROWS( batch_solver.solve_batch(batch_input, 0) );
+  CHECK_THROWS( batch_solver.solve_batch(vector<sdouble32>(net->input_data_size()), batch_size) ); /* Input too small */
+}
+
+/*###############################################################################################
+ * Testing if the inputs of a @Solution with input transformations are preprocessed while gathered:
+ * - The results from the raw inputs shall match the results of a @Solution without transformations
+ *   solving the inputs preprocessed in advance, for single inputs, batches and checked solving
+ * - Invalid transformations shall be refused by the solver
+ * */
+TEST_CASE("Solution Solver preprocessing the inputs", "[solve][input-transform]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+  using sparse_net_library::Input_transform;
+  using sparse_net_library::Input_transformer;
+
+  vector<uint32> net_structure = {6,8,5,3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(5).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> plain_solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = plain_solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  plain_solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/3.0).build(*net));
+  CHECK( 0 == plain_solution->input_transforms_size() );
+
+  for(uint32 input_iterator = 0; input_iterator < net->input_data_size(); ++input_iterator){
+    Input_transform& transform = *net->add_input_transforms();
+    transform.set_scale(0.2 * static_cast<sdouble32>(input_iterator + 1));
+    transform.set_offset(1.5 - static_cast<sdouble32>(input_iterator));
+    transform.set_min_value((0 == (input_iterator % 2))?(-std::numeric_limits<sdouble32>::infinity()):(0.0));
+    transform.set_max_value((0 == (input_iterator % 3))?(std::numeric_limits<sdouble32>::infinity()):(1.0));
+  }
+  unique_ptr<Solution> solution(solution_builder->build(*net));
+  REQUIRE( net->input_transforms_size() == solution->input_transforms_size() );
+  CHECK( net->input_transforms(1).SerializeAsString() == solution->input_transforms(1).SerializeAsString() );
+
+  const uint32 batch_size = 3;
+  Solution_solver plain_solver(*plain_solution);
+  Solution_solver plain_batch_solver(*plain_solution);
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  Solution_solver checked_solver(*solution, Service_context().set_checked_solve(true));
+  Solution_solver batch_solver(*solution);
+  vector<sdouble32> network_input(net->input_data_size());
+  vector<sdouble32> preprocessed_input(net->input_data_size());
+  vector<sdouble32> batch_input(net->input_data_size() * batch_size);
+  vector<sdouble32> preprocessed_batch_input(net->input_data_size() * batch_size);
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(uint32 input_iterator = 0; input_iterator < network_input.size(); ++input_iterator){
+      network_input[input_iterator] = static_cast<sdouble32>(rand()%100) / 10.0 - 5.0;
+      preprocessed_input[input_iterator] = Input_transformer::get_value(net->input_transforms(input_iterator), network_input[input_iterator]);
+    }
+    for(uint32 lane_iterator = 0; lane_iterator < batch_input.size(); ++lane_iterator){
+      batch_input[lane_iterator] = static_cast<sdouble32>(rand()%100) / 10.0 - 5.0;
+      preprocessed_batch_input[lane_iterator] = Input_transformer::get_value(
+        net->input_transforms(lane_iterator / batch_size), batch_input[lane_iterator]
+      );
+    }
+    vector<sdouble32> expected_result = plain_solver.solve(preprocessed_input);
+    vector<sdouble32> result = solver.solve(network_input);
+    vector<sdouble32> checked_result = checked_solver.solve(network_input);
+    vector<sdouble32> expected_batch_result = plain_batch_solver.solve_batch(preprocessed_batch_input, batch_size);
+    vector<sdouble32> batch_result = batch_solver.solve_batch(batch_input, batch_size);
+    REQUIRE( expected_result.size() == result.size() );
+    REQUIRE( expected_result.size() == checked_result.size() );
+    REQUIRE( expected_batch_result.size() == batch_result.size() );
+    for(uint32 output_iterator = 0; output_iterator < result.size(); ++output_iterator){
+      CHECK( Approx(expected_result[output_iterator]).epsilon(0.00000000000001) == result[output_iterator] );
+      CHECK( Approx(expected_result[output_iterator]).epsilon(0.00000000000001) == checked_result[output_iterator] );
+    }
+    for(uint32 output_iterator = 0; output_iterator < batch_result.size(); ++output_iterator)
+      CHECK( Approx(expected_batch_result[output_iterator]).epsilon(0.00000000000001) == batch_result[output_iterator] );
+  }
+
+  Solution invalid_solution = *solution;
+  invalid_solution.mutable_input_transforms()->RemoveLast(); /* The last input has no transformation */
+  CHECK_THROWS( Solution_solver(invalid_solution) );
+  invalid_solution = *solution;
+  invalid_solution.mutable_input_transforms(0)->set_min_value(2.0);
+  invalid_solution.mutable_input_transforms(0)->set_max_value(1.0);
+  CHECK_THROWS( Solution_solver(invalid_solution) );
+}
+
+/*###############################################################################################
+ * Testing if a @Solution with a large multi-layer @Partial_solution is solved by multiple workers
+ * wavefront by wavefront, giving the same result as one solved by a single worker
+ * */
+TEST_CASE("Solution Solver dividing the wavefronts of partial solutions between workers", "[solve][ranges][wavefront]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {60,50,40,3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(10).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> solution(Solution_builder().max_solve_threads(1).device_max_megabytes(2048).build(*net));
+  REQUIRE( 1 == solution->partial_solutions_size() );
+
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(1));
+  Solution_solver wavefront_solver(*solution, Service_context().set_max_solve_threads(4));
+  Solution_solver checked_wavefront_solver(*solution, Service_context().set_max_solve_threads(4).set_checked_solve(true));
+  CHECK( 1 == solver.get_number_of_neuron_stages() );
+  CHECK( 1 < wavefront_solver.get_number_of_neuron_stages() );
+  CHECK( wavefront_solver.get_number_of_neuron_stages() < wavefront_solver.get_number_of_neuron_ranges() );
+
+  const uint32 batch_size = 3;
+  vector<sdouble32> input(net->input_data_size());
+  vector<sdouble32> batch_input(net->input_data_size() * batch_size);
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& element : input) element = static_cast<sdouble32>(rand()%100) / 10.0;
+    for(sdouble32& element : batch_input) element = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = solver.solve(input);
+    vector<sdouble32> output = wavefront_solver.solve(input);
+    vector<sdouble32> checked_output = checked_wavefront_solver.solve(input);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator){
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == checked_output[output_iterator] );
+    }
+    vector<sdouble32> expected_batch_output = solver.solve_batch(batch_input, batch_size);
+    vector<sdouble32> batch_output = wavefront_solver.solve_batch(batch_input, batch_size);
+    REQUIRE( expected_batch_output.size() == batch_output.size() );
+    for(uint32 output_iterator = 0; output_iterator < batch_output.size(); ++output_iterator)
+      CHECK( Approx(expected_batch_output[output_iterator]).epsilon(0.00000000000001) == batch_output[output_iterator] );
+  }
+}
+
+/*###############################################################################################
+ * Testing if a @Solution solved by multiple workers, with its large @Partial_solution elements
+ * divided into Neuron ranges, gives the same result as one solved by a single worker
+ * */
+TEST_CASE("Solution Solver dividing partial solutions between workers", "[solve][ranges]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {120,40,3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(10).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/3.0).build(*net));
+
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(1));
+  Solution_solver range_solver(*solution, Service_context().set_max_solve_threads(4).set_checked_solve(true));
+  CHECK( static_cast<uint32>(solution->partial_solutions_size()) == solver.get_number_of_neuron_ranges() );
+  CHECK( static_cast<uint32>(solution->partial_solutions_size()) < range_solver.get_number_of_neuron_ranges() );
+
+  const uint32 batch_size = 3;
+  vector<sdouble32> input(net->input_data_size());
+  vector<sdouble32> batch_input(net->input_data_size() * batch_size);
+  for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+    for(sdouble32& element : input) element = static_cast<sdouble32>(rand()%100) / 10.0;
+    for(sdouble32& element : batch_input) element = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = solver.solve(input);
+    vector<sdouble32> output = range_solver.solve(input);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+    vector<sdouble32> expected_batch_output = solver.solve_batch(batch_input, batch_size);
+    vector<sdouble32> batch_output = range_solver.solve_batch(batch_input, batch_size);
+    REQUIRE( expected_batch_output.size() == batch_output.size() );
+    for(uint32 output_iterator = 0; output_iterator < batch_output.size(); ++output_iterator)
+      CHECK( Approx(expected_batch_output[output_iterator]).epsilon(0.00000000000001) == batch_output[output_iterator] );
+  }
+}
+
+TEST_CASE("Solution Solver allocation free solving", "[solve][allocation]"){
+  using std::unique_ptr;
+  using std::make_unique;
+  using sparse_net_library::Sparse_net_builder;
+  using sparse_net_library::Solution_builder;
+  using sparse_net_library::SparseNet;
+
+  vector<uint32> net_structure = {10,8,12,4};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(6).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/3.0).build(*net));
+
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  vector<sdouble32> input(net->input_data_size());
+  vector<sdouble32> output;
+  const uint32 batch_size = 5;
+  vector<sdouble32> batch_input(net->input_data_size() * batch_size);
+  vector<sdouble32> batch_output;
+  for(uint32 warmup_iterator = 0; warmup_iterator < 10; ++warmup_iterator){
+    solver.solve(input, output);
+    solver.solve_batch(batch_input, batch_size, batch_output);
+  }
+
+  number_of_allocations = 0;
+  counting_allocations = true;
+  for(uint32 variant_iterator = 0; variant_iterator < 100; ++variant_iterator){
+    input[variant_iterator % input.size()] = static_cast<sdouble32>(variant_iterator) / 10.0;
+    batch_input[variant_iterator % batch_input.size()] = static_cast<sdouble32>(variant_iterator) / 10.0;
+    solver.solve(input, output);
+    solver.solve_batch(batch_input, batch_size, batch_output);
+  }
+  counting_allocations = false;
+  CHECK( 0 == number_of_allocations );
+  CHECK( solution->output_neuron_number() == output.size() );
+  CHECK( (solution->output_neuron_number() * batch_size) == batch_output.size() );
+}
+
+/*###############################################################################################
+ * Testing if the solution solver can be constructed for a @Solution of many @Partial_solution elements:
+ * every @Partial_solution is built by @manual_2_neuron_partial_solution, taking the first two network inputs,
+ * so every output pair is (input0 + input1 + 50, input0 + input1 + 60)
+ */
+TEST_CASE("Solution Solver construction for a large Solution", "[solve][construction]"){
+  const uint32 number_of_rows = 100;
+  const uint32 partials_in_row = 200;
+  Solution solution;
+  Synapse_interval input_synapse;
+  input_synapse.set_starts(Synapse_iterator::synapse_index_from_input_index(0));
+  input_synapse.set_interval_size(2);
+  for(uint32 row_iterator = 0; row_iterator < number_of_rows; ++row_iterator){
+    solution.add_cols(partials_in_row);
+    for(uint32 col_iterator = 0; col_iterator < partials_in_row; ++col_iterator){
+      Partial_solution& partial = *solution.add_partial_solutions();
+      manual_2_neuron_partial_solution(partial, 2, 2 * (solution.partial_solutions_size() - 1));
+      *partial.add_input_data() = input_synapse;
+    }
+  }
+  solution.set_neuron_number(2 * solution.partial_solutions_size());
+  solution.set_output_neuron_number(solution.neuron_number());
+
+  Solution_solver solver(solution, Service_context().set_max_solve_threads(4));
+
+  vector<sdouble32> input = {1.5, 2.5};
+  vector<sdouble32> output = solver.solve(input);
+  REQUIRE( solution.neuron_number() == output.size() );
+  for(uint32 output_iterator = 0; output_iterator < output.size(); output_iterator += 2){
+    CHECK( Approx(54.0).epsilon(0.00000000000001) == output[output_iterator] );
+    CHECK( Approx(64.0).epsilon(0.00000000000001) == output[output_iterator + 1] );
+  }
+}
+
+/*###############################################################################################
+ * Testing if Neurons can take the data of any Neuron from the previous run through delayed inputs,
+ * without unrolling the network: the net below has a Neuron reading itself, one reading an output Neuron
+ * after it, and an output Neuron reading itself. Every run is compared to the recurrence calculated by hand.
+ */
+sparse_net_library::SparseNet* build_recurrent_net(void){
+  const vector<sdouble32> weight_table = {
+    0.5, 0.25, 0.125, /* Neuron 0: input 0, itself delayed, bias */
+    -0.75, 0.5, 0.25, /* Neuron 1: input 1, Neuron 2 delayed, bias */
+    1.5, -0.5, 0.0625, /* Neuron 2: Neurons 0 and 1, bias */
+    0.25, 0.75, -0.125, /* Neuron 3: Neuron 0, itself delayed, bias */
+    0.0 /* Memory filter of every Neuron */
+  };
+  const vector<vector<std::pair<sparse_net_library::sint32, bool>>> neuron_inputs = {
+    {{Synapse_iterator::synapse_index_from_input_index(0), false}, {0, true}},
+    {{Synapse_iterator::synapse_index_from_input_index(1), false}, {2, true}},
+    {{0, false}, {1, false}},
+    {{0, false}, {3, true}}
+  };
+  vector<sparse_net_library::Neuron> neuron_array(neuron_inputs.size());
+  for(uint32 neuron_iterator = 0; neuron_iterator < neuron_array.size(); ++neuron_iterator){
+    sparse_net_library::Neuron& neuron = neuron_array[neuron_iterator];
+    for(const std::pair<sparse_net_library::sint32, bool>& input : neuron_inputs[neuron_iterator]){
+      Synapse_interval* input_synapse = neuron.add_input_indices();
+      input_synapse->set_starts(input.first);
+      input_synapse->set_interval_size(1);
+      input_synapse->set_delayed(input.second);
+    }
+    Synapse_interval* weight_synapse = neuron.add_input_weights();
+    weight_synapse->set_starts(neuron_iterator * 3);
+    weight_synapse->set_interval_size(2);
+    neuron.set_bias_idx(neuron_iterator * 3 + 2);
+    neuron.set_memory_filter_idx(weight_table.size() - 1);
+    neuron.set_transfer_function_idx(sparse_net_library::TRANSFER_FUNCTION_IDENTITY);
+  }
+  return sparse_net_library::Sparse_net_builder()
+    .input_size(2).expected_input_range(1.0).output_neuron_number(2)
+    .cost_function(COST_FUNCTION_QUADRATIC).neuron_array(neuron_array).weight_table(weight_table)
+    .build();
+}
+
+/* Calculates the outputs of the net above for a sequence of inputs, starting from Neurons of 0 */
+vector<vector<sdouble32>> recurrent_net_outputs(const vector<vector<sdouble32>>& inputs){
+  vector<vector<sdouble32>> outputs;
+  sdouble32 neuron_0 = 0.0, neuron_2 = 0.0, neuron_3 = 0.0;
+  for(const vector<sdouble32>& input : inputs){
+    const sdouble32 new_neuron_0 = 0.5 * input[0] + 0.25 * neuron_0 + 0.125;
+    const sdouble32 new_neuron_1 = -0.75 * input[1] + 0.5 * neuron_2 + 0.25;
+    neuron_2 = 1.5 * new_neuron_0 - 0.5 * new_neuron_1 + 0.0625;
+    neuron_3 = 0.25 * new_neuron_0 + 0.75 * neuron_3 - 0.125;
+    neuron_0 = new_neuron_0;
+    outputs.push_back({neuron_2, neuron_3});
+  }
+  return outputs;
+}
+
+TEST_CASE("Solution Solver delayed Neuron inputs", "[solve][delayed]"){
+  using std::unique_ptr;
+  unique_ptr<sparse_net_library::SparseNet> net(build_recurrent_net());
+  unique_ptr<Solution> solution(sparse_net_library::Solution_builder().build(*net));
+  uint32 delayed_inputs = 0;
+  for(const Partial_solution& partial : solution->partial_solutions())
+    for(const Synapse_interval& input_synapse : partial.input_data())
+      if(input_synapse.delayed()) delayed_inputs += input_synapse.interval_size();
+  CHECK( 3 == delayed_inputs );
+  CHECK_THROWS( Partial_solution_solver(solution->partial_solutions(0)) ); /* Only the Solution solver keeps the previous run */
+
+  const vector<vector<sdouble32>> sequence = {{0.5, -0.25}, {1.0, 0.75}, {-0.5, 0.0}, {0.25, 1.0}, {0.0, -1.0}};
+  const vector<vector<sdouble32>> other_sequence = {{-1.0, 0.5}, {0.0, 0.0}, {0.75, -0.5}, {1.0, 1.0}, {-0.25, 0.25}};
+  const vector<vector<sdouble32>> expected = recurrent_net_outputs(sequence);
+  const vector<vector<sdouble32>> other_expected = recurrent_net_outputs(other_sequence);
+
+  Solution_solver solver(*solution);
+  for(uint32 step = 0; step < sequence.size(); ++step){
+    const vector<sdouble32> result = solver.solve(sequence[step]);
+    REQUIRE( 2 == result.size() );
+    for(uint32 output_iterator = 0; output_iterator < result.size(); ++output_iterator)
+      CHECK( Approx(expected[step][output_iterator]).epsilon(0.00000000000001) == result[output_iterator] );
+  }
+
+  /* Submitted inputs wait for the Neuron data of the ones before them */
+  Solution_solver submitted_solver(*solution, Service_context().set_max_solve_threads(4));
+  vector<std::future<vector<sdouble32>>> results;
+  for(const vector<sdouble32>& input : sequence)
+    results.push_back(submitted_solver.submit(input));
+  for(uint32 step = 0; step < sequence.size(); ++step){
+    const vector<sdouble32> result = results[step].get();
+    for(uint32 output_iterator = 0; output_iterator < result.size(); ++output_iterator)
+      CHECK( Approx(expected[step][output_iterator]).epsilon(0.00000000000001) == result[output_iterator] );
+  }
+
+  /* Every sample of a batch continues its own sequence */
+  const uint32 batch_size = 2;
+  Solution_solver batch_solver(*solution, Service_context().set_checked_solve(true));
+  for(uint32 step = 0; step < sequence.size(); ++step){
+    vector<sdouble32> inputs(2 * batch_size);
+    for(uint32 input_iterator = 0; input_iterator < 2; ++input_iterator){
+      inputs[input_iterator * batch_size] = sequence[step][input_iterator];
+      inputs[input_iterator * batch_size + 1] = other_sequence[step][input_iterator];
+    }
+    const vector<sdouble32> result = batch_solver.solve_batch(inputs, batch_size);
+    REQUIRE( (2 * batch_size) == result.size() );
+    for(uint32 output_iterator = 0; output_iterator < 2; ++output_iterator){
+      CHECK( Approx(expected[step][output_iterator]).epsilon(0.00000000000001) == result[output_iterator * batch_size] );
+      CHECK( Approx(other_expected[step][output_iterator]).epsilon(0.00000000000001) == result[output_iterator * batch_size + 1] );
+    }
+  }
+}
+
 } /* namespace sparse_net_library_test */
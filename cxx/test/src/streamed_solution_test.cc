@@ -0,0 +1,146 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+#include "gen/sparse_net.pb.h"
+#include "gen/solution.pb.h"
+#include "models/service_context.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/streamed_solution.h"
+#include "services/streamed_solution_solver.h"
+#include "services/synapse_iterator.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint32;
+using sparse_net_library::uint64;
+using sparse_net_library::sint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Partial_solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::Streamed_solution;
+using sparse_net_library::Streamed_solution_solver;
+using sparse_net_library::Synapse_iterator;
+using sparse_net_library::Synapse_interval;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if a @Solution stored row by row is read back the same, and solving it from the file
+ * gives the same result as solving it in memory:
+ * - Every Neuron of the @Solution is given memory, so the Neuron memory kept between the inputs is tested as well
+ * - No more than two rows shall be in memory at once
+ * - Invalid files, and @Partial_solution elements with delayed inputs shall be rejected
+ * */
+TEST_CASE( "Solving a Solution streamed from a file row by row", "[solve][streaming]" ){
+  vector<uint32> net_structure = {20,30,10,2};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(10).output_neuron_number(2)
+  .expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution_builder> solution_builder = make_unique<Solution_builder>();
+  unique_ptr<Solution> solution(solution_builder->max_solve_threads(4).device_max_megabytes(2048).build(*net));
+  sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  solution.reset(solution_builder->max_solve_threads(4).device_max_megabytes(solution_size/5.0).build(*net));
+  REQUIRE( 2 < solution->cols_size() );
+  for(Partial_solution& partial : *solution->mutable_partial_solutions()){
+    for(uint32 neuron_iterator = 0; neuron_iterator < partial.internal_neuron_number(); ++neuron_iterator){
+      partial.set_weight_table(partial.memory_filter_index(neuron_iterator), 0.25);
+      if(0 < partial.neuron_memoryless_size()) partial.set_neuron_memoryless(neuron_iterator, false);
+    }
+  }
+
+  const std::string file_name = "streamed_solution_test.snl";
+  Streamed_solution::write(*solution, file_name);
+  {
+    Streamed_solution streamed_solution(file_name);
+    REQUIRE( static_cast<uint32>(solution->cols_size()) == streamed_solution.get_number_of_rows() );
+    CHECK( solution->neuron_number() == streamed_solution.get_head().neuron_number() );
+    CHECK( solution->output_neuron_number() == streamed_solution.get_head().output_neuron_number() );
+    CHECK( 0 == streamed_solution.get_head().partial_solutions_size() );
+    sint32 partial_iterator = 0;
+    uint64 largest_two_rows = 0;
+    for(uint32 row_iterator = 0; row_iterator < streamed_solution.get_number_of_rows(); ++row_iterator){
+      vector<Partial_solution> partials = streamed_solution.read_row(row_iterator);
+      REQUIRE( solution->cols(row_iterator) == partials.size() );
+      for(const Partial_solution& partial : partials){
+        CHECK( solution->partial_solutions(partial_iterator).SerializeAsString() == partial.SerializeAsString() );
+        ++partial_iterator;
+      }
+      if((row_iterator + 1) < streamed_solution.get_number_of_rows())
+        largest_two_rows = std::max(largest_two_rows, streamed_solution.get_row_bytes(row_iterator) + streamed_solution.get_row_bytes(row_iterator + 1));
+    }
+
+    Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+    Streamed_solution_solver streamed_solver(streamed_solution, Service_context().set_max_solve_threads(4));
+    Streamed_solution_solver checked_streamed_solver(streamed_solution, Service_context().set_checked_solve(true));
+    vector<sdouble32> network_inputs(net->input_data_size());
+    for(uint32 variant_iterator = 0; variant_iterator < 10; ++variant_iterator){
+      for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+      vector<sdouble32> expected_output = solver.solve(network_inputs);
+      vector<sdouble32> output = streamed_solver.solve(network_inputs);
+      vector<sdouble32> checked_output = checked_streamed_solver.solve(network_inputs);
+      REQUIRE( expected_output.size() == output.size() );
+      REQUIRE( expected_output.size() == checked_output.size() );
+      for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator){
+        CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+        CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == checked_output[output_iterator] );
+      }
+    }
+    CHECK( largest_two_rows == streamed_solver.get_max_row_bytes_in_memory() );
+    CHECK_THROWS( streamed_solver.solve(vector<sdouble32>(1)) );
+
+    /* After a reset the memory of the Neurons starts from zero again, the same as with a new solver */
+    Solution_solver new_solver(*solution);
+    streamed_solver.reset();
+    vector<sdouble32> expected_output = new_solver.solve(network_inputs);
+    vector<sdouble32> output = streamed_solver.solve(network_inputs);
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+
+  { /* Delayed inputs are refused with their own error, even though the @Solution_solver accepts them */
+    Solution delayed_solution = *solution;
+    Partial_solution& last_partial = *delayed_solution.mutable_partial_solutions()->rbegin();
+    auto neuron_input = std::find_if(
+      last_partial.mutable_input_data()->begin(), last_partial.mutable_input_data()->end(),
+      [](const Synapse_interval& input_synapse){ return !Synapse_iterator::is_index_input(input_synapse.starts()); }
+    );
+    REQUIRE( last_partial.mutable_input_data()->end() != neuron_input );
+    neuron_input->set_delayed(true);
+    CHECK( Solution_solver(delayed_solution).is_valid() );
+    Streamed_solution::write(delayed_solution, file_name);
+    CHECK_THROWS_WITH(
+      Streamed_solution_solver(Streamed_solution(file_name)),
+      "Delayed Neuron inputs are not supported in a streamed Solution!"
+    );
+    Streamed_solution::write(*solution, file_name);
+  }
+
+  { /* A file cut in half can't be read */
+    std::ifstream whole_file(file_name, std::ios::binary);
+    std::string file_bytes((std::istreambuf_iterator<char>(whole_file)), std::istreambuf_iterator<char>());
+    std::ofstream cut_file(file_name, std::ios::binary | std::ios::trunc);
+    cut_file.write(file_bytes.data(), file_bytes.size() / 2);
+  }
+  CHECK_THROWS( Streamed_solution_solver(Streamed_solution(file_name)) );
+  std::remove(file_name.c_str());
+  CHECK_THROWS( Streamed_solution(file_name) );
+}
+
+} /* namespace sparse_net_library_test */
@@ -3,6 +3,7 @@
 #include "sparse_net_global.h"
 #include "gen/sparse_net.pb.h"
 #include "services/synapse_iterator.h"
+#include "services/packed_synapses.h"
 
 
 
@@ -16,6 +17,7 @@ using sparse_net_library::sint32;
 using sparse_net_library::Neuron;
 using sparse_net_library::Synapse_iterator;
 using sparse_net_library::Synapse_interval;
+using sparse_net_library::Packed_synapses;
 
 
 /*###############################################################################################
@@ -213,4 +215,58 @@ TEST_CASE("Synapse Iterator Utility functions","[synapse_iteration]"){
 }
 
 
+/*###############################################################################################
+ * Testing packed synapses
+ * - Packing artificial synapses with positive and negative, nearby and distant starts in two sequences
+ * - Iterating and skimming every sequence by itself shall give the same indexes as the @Synapse_iterator
+ * - Fragmented nearby synapses shall take only a few bytes
+ */
+TEST_CASE("Packed synapse iteration","[synapse_iteration][packed]"){
+  Neuron neuron = Neuron();
+  Synapse_interval temp_synapse_interval;
+  vector<vector<sint32>> synapse_indexes = {
+    {-50,10},{70,30},{-20,70},{100,1},{101,1},{103,2},{2147483000,600},{-2147483000,5},{0,0},{5,200},{-1,1}
+  }; /* {{range},{start,length},{range}..} */
+  for(uint32 i = 0; i < synapse_indexes.size(); ++i){
+    temp_synapse_interval.set_starts(synapse_indexes[i][0]);
+    temp_synapse_interval.set_interval_size(synapse_indexes[i][1]);
+    *neuron.add_input_indices() = temp_synapse_interval;
+  }
+
+  Packed_synapses packed;
+  const uint32 first_sequence_size = 5;
+  const uint32 first_sequence = packed.pack(neuron.input_indices(), 0, first_sequence_size);
+  const uint32 second_sequence = packed.pack(neuron.input_indices(), first_sequence_size, synapse_indexes.size() - first_sequence_size);
+  CHECK( 0 == first_sequence );
+  CHECK( first_sequence < second_sequence );
+
+  Synapse_iterator iter(neuron.input_indices());
+  vector<int> expected_indexes;
+  vector<int> packed_indexes;
+  iter.iterate([&](int index){ expected_indexes.push_back(index); });
+  packed.iterate_inline([&](int index){ packed_indexes.push_back(index); }, first_sequence, first_sequence_size);
+  packed.iterate_inline(
+    [&](int index){ packed_indexes.push_back(index); }, second_sequence, synapse_indexes.size() - first_sequence_size
+  );
+  CHECK( expected_indexes == packed_indexes );
+
+  uint32 manual_index = first_sequence_size;
+  packed.skim_inline([&](sint32 synapse_start, uint32 synapse_size){
+    CHECK( synapse_start == synapse_indexes[manual_index][0] );
+    CHECK( static_cast<sint32>(synapse_size) == synapse_indexes[manual_index][1] );
+    ++manual_index;
+  }, second_sequence, synapse_indexes.size() - first_sequence_size);
+  CHECK( synapse_indexes.size() == manual_index );
+
+  Neuron fragmented_neuron = Neuron();
+  for(sint32 i = 0; i < 100; ++i){ /* Every other index */
+    temp_synapse_interval.set_starts(1000 + 2 * i);
+    temp_synapse_interval.set_interval_size(1);
+    *fragmented_neuron.add_input_indices() = temp_synapse_interval;
+  }
+  Packed_synapses packed_fragments;
+  packed_fragments.pack(fragmented_neuron.input_indices(), 0, fragmented_neuron.input_indices_size());
+  CHECK( (2 * 100 + 16) >= packed_fragments.get_size_in_bytes() ); /* 2 bytes for every synapse */
+}
+
 } /* namespace sparse_library_test */
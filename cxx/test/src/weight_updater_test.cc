@@ -0,0 +1,166 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <memory>
+
+#include "gen/common.pb.h"
+#include "gen/solution.pb.h"
+#include "gen/sparse_net.pb.h"
+#include "models/service_context.h"
+#include "services/sparse_net_builder.h"
+#include "services/solution_builder.h"
+#include "services/solution_solver.h"
+#include "services/partial_solution_solver.h"
+#include "services/weight_updater.h"
+
+namespace sparse_net_library_test {
+
+using std::unique_ptr;
+using std::make_unique;
+using std::vector;
+
+using sparse_net_library::uint32;
+using sparse_net_library::sdouble32;
+using sparse_net_library::Service_context;
+using sparse_net_library::Sparse_net_builder;
+using sparse_net_library::SparseNet;
+using sparse_net_library::Neuron;
+using sparse_net_library::Solution_builder;
+using sparse_net_library::Solution;
+using sparse_net_library::Partial_solution;
+using sparse_net_library::Solution_solver;
+using sparse_net_library::Partial_solution_solver;
+using sparse_net_library::Weight_updater;
+using sparse_net_library::weight_storages;
+using sparse_net_library::WEIGHT_STORAGE_DOUBLE;
+using sparse_net_library::WEIGHT_STORAGE_FP16;
+using sparse_net_library::COST_FUNCTION_QUADRATIC;
+
+/*###############################################################################################
+ * Testing if the weights of a built @Solution are updated in place the same way building the
+ * @Solution again from the updated @SparseNet would set them:
+ * - Some weights, biases and a memory filter of the net are changed, and given to the updater as a delta
+ * - A memory filter too small for the weight storage shall keep its Neuron stateful, as it would after a rebuild
+ * - The updated @Solution shall be the same as the one built again, in every weight storage
+ * - A solver constructed before the update shall give the same results as a new solver of the rebuilt @Solution
+ * - Updating from the whole @SparseNet shall restore the original @Solution
+ * */
+void test_weight_update(weight_storages storage){
+  vector<uint32> net_structure = {20,15,5};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(10).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  net->set_weight_table(net->neuron_array(25).memory_filter_idx(), 0.0); /* A stateless Neuron in the middle of the net */
+  unique_ptr<Solution> solution(Solution_builder().build(*net));
+  const sdouble32 solution_size = solution->SpaceUsedLong() /* Bytes *// 1024.0 /* KB *// 1024.0 /* MB */;
+  Solution_builder solution_builder;
+  solution_builder.max_solve_threads(4).device_max_megabytes(solution_size / 3.0).weight_storage(storage);
+  solution.reset(solution_builder.build(*net));
+  REQUIRE( 1 < solution->partial_solutions_size() );
+  const Solution original_solution = *solution;
+
+  /* Change every 7th weight, and give a memory filter to the stateless Neuron */
+  SparseNet updated_net = *net;
+  vector<uint32> changed_weights;
+  vector<sdouble32> new_weights;
+  for(int weight_index = 0; weight_index < updated_net.weight_table_size(); weight_index += 7){
+    changed_weights.push_back(weight_index);
+    new_weights.push_back(updated_net.weight_table(weight_index) * -0.5 + 0.125);
+  }
+  const Neuron& neuron_with_memory = updated_net.neuron_array(25);
+  changed_weights.push_back(neuron_with_memory.memory_filter_idx());
+  new_weights.push_back(0.5);
+  changed_weights.push_back(updated_net.neuron_array(26).memory_filter_idx());
+  new_weights.push_back(0.000000001); /* Rounded to zero in 16 bits, but the Neuron still keeps its memory */
+  for(uint32 change_iterator = 0; change_iterator < changed_weights.size(); ++change_iterator)
+    updated_net.set_weight_table(changed_weights[change_iterator], new_weights[change_iterator]);
+
+  Solution_solver solver(*solution, Service_context().set_max_solve_threads(4));
+  Weight_updater updater(*solution);
+  CHECK( updater.get_number_of_net_weights() <= static_cast<uint32>(net->weight_table_size()) );
+  CHECK( updater.update(changed_weights, new_weights) ); /* The Neuron with memory is now stateful */
+  solver.refresh_neurons();
+
+  unique_ptr<Solution> rebuilt_solution(solution_builder.build(updated_net));
+  REQUIRE( rebuilt_solution->partial_solutions_size() == solution->partial_solutions_size() );
+  for(int partial_index = 0; partial_index < solution->partial_solutions_size(); ++partial_index){
+    CHECK(
+      rebuilt_solution->partial_solutions(partial_index).SerializeAsString()
+      == solution->partial_solutions(partial_index).SerializeAsString()
+    );
+  }
+
+  Solution_solver rebuilt_solver(*rebuilt_solution);
+  vector<sdouble32> network_inputs(net->input_data_size());
+  for(uint32 variant_iterator = 0; variant_iterator < 5; ++variant_iterator){
+    for(sdouble32& input : network_inputs) input = static_cast<sdouble32>(rand()%100) / 10.0;
+    vector<sdouble32> expected_output = rebuilt_solver.solve(network_inputs);
+    vector<sdouble32> output = solver.solve(network_inputs);
+    REQUIRE( expected_output.size() == output.size() );
+    for(uint32 output_iterator = 0; output_iterator < output.size(); ++output_iterator)
+      CHECK( Approx(expected_output[output_iterator]).epsilon(0.00000000000001) == output[output_iterator] );
+  }
+
+  CHECK( updater.update(*net) ); /* The Neuron with memory is stateless again */
+  CHECK( original_solution.SerializeAsString() == solution->SerializeAsString() );
+  CHECK_FALSE( updater.update(*net) );
+  CHECK_FALSE( updater.update({static_cast<uint32>(net->weight_table_size()) + 10u}, {1.0}) ); /* Weights not in the solution are ignored */
+  CHECK( original_solution.SerializeAsString() == solution->SerializeAsString() );
+  CHECK_THROWS( updater.update({0u, 1u}, {1.0}) );
+  CHECK_THROWS( updater.update(SparseNet()) );
+
+  solution->mutable_partial_solutions(0)->mutable_weight_sources()->RemoveLast();
+  CHECK_THROWS( Weight_updater(*solution) );
+}
+
+TEST_CASE( "Updating the weights of a Solution in place", "[weight-update]" ){
+  test_weight_update(WEIGHT_STORAGE_DOUBLE);
+  test_weight_update(WEIGHT_STORAGE_FP16);
+}
+
+/*###############################################################################################
+ * Testing if the memory of the Neurons is kept when they are classified again after a memory filter update:
+ * - Neurons staying stateful keep their memory
+ * - Neurons becoming stateful start from an empty memory
+ * */
+TEST_CASE( "Refreshing the Neurons of a Partial solution solver", "[weight-update]" ){
+  vector<uint32> net_structure = {3};
+  unique_ptr<Sparse_net_builder> net_builder = make_unique<Sparse_net_builder>();
+  net_builder->input_size(2).expected_input_range(5.0).cost_function(COST_FUNCTION_QUADRATIC);
+  unique_ptr<SparseNet> net(net_builder->dense_layers(net_structure));
+  unique_ptr<Solution> solution(Solution_builder().build(*net));
+  REQUIRE( 1 == solution->partial_solutions_size() );
+  Partial_solution partial = solution->partial_solutions(0);
+  partial.set_weight_table(partial.memory_filter_index(0), 0.5);
+  partial.set_neuron_memoryless(0, false);
+  partial.set_weight_table(partial.memory_filter_index(1), 0.0);
+  partial.set_neuron_memoryless(1, true);
+  partial.set_weight_table(partial.memory_filter_index(2), 0.0);
+  partial.set_neuron_memoryless(2, true);
+  const Partial_solution stateless_partial = partial; /* The second Neuron stays stateless in this one */
+
+  Partial_solution_solver solver(partial);
+  Partial_solution_solver reference_solver(stateless_partial);
+  const vector<sdouble32> neuron_data;
+  for(const vector<sdouble32>& network_input : vector<vector<sdouble32>>{{1.0, 2.0}, {-3.0, 0.5}}){
+    solver.collect_input_data(network_input, neuron_data);
+    solver.solve();
+    reference_solver.collect_input_data(network_input, neuron_data);
+    reference_solver.solve();
+  }
+  CHECK( 1 == solver.get_neuron_memory_size() );
+
+  partial.set_weight_table(partial.memory_filter_index(1), 0.5);
+  partial.set_neuron_memoryless(1, false);
+  solver.refresh_neurons();
+  CHECK( 2 == solver.get_neuron_memory_size() );
+  solver.collect_input_data({0.7, -1.5}, neuron_data);
+  vector<sdouble32> output = solver.solve();
+  reference_solver.collect_input_data({0.7, -1.5}, neuron_data);
+  vector<sdouble32> expected_output = reference_solver.solve();
+  CHECK( Approx(expected_output[0]).epsilon(0.00000000000001) == output[0] ); /* memory kept */
+  CHECK( Approx(expected_output[1] * 0.5).epsilon(0.00000000000001) == output[1] ); /* memory started from zero */
+  CHECK( Approx(expected_output[2]).epsilon(0.00000000000001) == output[2] );
+}
+
+} /* namespace sparse_net_library_test */
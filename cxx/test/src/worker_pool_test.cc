@@ -0,0 +1,94 @@
+#include "test/catch.hpp"
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "services/worker_pool.h"
+
+namespace sparse_net_library_test {
+
+using std::vector;
+
+using sparse_net_library::uint16;
+using sparse_net_library::uint32;
+using sparse_net_library::uint64;
+using sparse_net_library::Worker_pool;
+
+/*###############################################################################################
+ * Testing if the tasks pushed by a task are stolen by the other workers:
+ * - A task pushes smaller tasks into the deque of its own worker, then waits for them to finish
+ * - Since the worker of the task is busy waiting, only the other workers can run the smaller tasks
+ * */
+TEST_CASE( "Stealing tasks between workers", "[workers]" ){
+  Worker_pool workers(4);
+  const uint32 number_of_subtasks = 100;
+  std::atomic<uint32> subtasks_done(0);
+  std::atomic<uint32> subtasks_on_other_workers(0);
+  std::mutex done_mutex;
+  std::condition_variable done_changed;
+  bool parent_done = false;
+
+  workers.push([&](uint16 parent_worker){
+    for(uint32 subtask_iterator = 0; subtask_iterator < number_of_subtasks; ++subtask_iterator){
+      workers.push([&, parent_worker](uint16 worker_index){
+        if(parent_worker != worker_index) ++subtasks_on_other_workers;
+        if(number_of_subtasks == ++subtasks_done){
+          std::lock_guard<std::mutex> my_lock(done_mutex);
+          done_changed.notify_all();
+        }
+      });
+    }
+    std::unique_lock<std::mutex> my_lock(done_mutex);
+    done_changed.wait(my_lock, [&](){ return number_of_subtasks == subtasks_done; });
+    parent_done = true;
+    done_changed.notify_all();
+  });
+
+  std::unique_lock<std::mutex> my_lock(done_mutex);
+  done_changed.wait(my_lock, [&](){ return parent_done; });
+  CHECK( number_of_subtasks == subtasks_done );
+  CHECK( number_of_subtasks == subtasks_on_other_workers );
+  CHECK( number_of_subtasks <= workers.get_number_of_stolen_tasks() );
+}
+
+/*###############################################################################################
+ * Testing if every task pushed from outside the pool, and every chunk of a range is run exactly once
+ * */
+TEST_CASE( "Distributing tasks between workers", "[workers]" ){
+  Worker_pool workers(3);
+  const uint32 number_of_tasks = 300;
+  vector<std::atomic<uint32>> tasks_of_worker(workers.get_number_of_workers());
+  for(std::atomic<uint32>& tasks : tasks_of_worker) tasks = 0;
+  std::atomic<uint32> tasks_done(0);
+  std::mutex done_mutex;
+  std::condition_variable done_changed;
+  for(uint32 task_iterator = 0; task_iterator < number_of_tasks; ++task_iterator){
+    workers.push([&](uint16 worker_index){
+      ++tasks_of_worker[worker_index];
+      if(number_of_tasks == ++tasks_done){
+        std::lock_guard<std::mutex> my_lock(done_mutex);
+        done_changed.notify_all();
+      }
+    });
+  }
+  {
+    std::unique_lock<std::mutex> my_lock(done_mutex);
+    done_changed.wait(my_lock, [&](){ return number_of_tasks == tasks_done; });
+  }
+  uint32 all_tasks = 0;
+  for(std::atomic<uint32>& tasks : tasks_of_worker) all_tasks += tasks;
+  CHECK( number_of_tasks == all_tasks );
+
+  /* Every chunk is run once */
+  vector<uint32> element_runs(1000, 0);
+  workers.run_in_chunks(element_runs.size(), [&](uint16, uint32 chunk_start, uint32 chunk_end){
+    for(uint32 element_iterator = chunk_start; element_iterator < chunk_end; ++element_iterator)
+      ++element_runs[element_iterator];
+  });
+  for(uint32 element_iterator = 0; element_iterator < element_runs.size(); ++element_iterator)
+    REQUIRE( 1 == element_runs[element_iterator] );
+}
+
+} /* namespace sparse_net_library_test */
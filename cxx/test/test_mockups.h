@@ -2,6 +2,7 @@
 #define sparse_net_TEST_MOCKUPS_H
 
 #include <vector>
+#include <atomic>
 
 #include "sparse_net_global.h"
 #include "gen/sparse_net.pb.h"
@@ -11,6 +12,7 @@ namespace sparse_net_library_test {
 
 using std::vector;
 
+using sparse_net_library::uint64;
 using sparse_net_library::uint32;
 using sparse_net_library::sdouble32;
 using sparse_net_library::sdouble32;
@@ -51,6 +53,13 @@ extern void manual_2_neuron_result(const vector<sdouble32>& partial_inputs, vect
 extern void manaual_fully_connected_network_result(vector<sdouble32> inputs, vector<sdouble32>& neuron_data,
     vector<uint32> layer_structure, SparseNet network);
 
+/**
+ * @brief      The global operator new of the tests counts the heap allocations of every thread
+ *             in @number_of_allocations while @counting_allocations is set
+ */
+extern std::atomic<bool> counting_allocations;
+extern std::atomic<uint64> number_of_allocations;
+
 };
 
 #endif /* sparse_net_TEST_MOCKUPS_H */